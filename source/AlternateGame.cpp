@@ -8,6 +8,27 @@
 #include<math.h>
 #include<chrono>
 #include <algorithm>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <array>
+#include <mutex>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <deque>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <signal.h>
+#endif
 std::random_device rnd;
 std::mt19937 mt(rnd());
 
@@ -16,54 +37,178 @@ using Actions = std::vector<int>;
 using ScoreType = int64_t;
 constexpr const ScoreType INF = 1000000000LL;
 // ԂǗNX
+// Ԑ̕ύXƒf͕ʃXbhs
 class TimeKeeper {
 private:
 	std::chrono::high_resolution_clock::time_point start_time_;
-	int64_t time_threshold_;
+	std::atomic<int64_t> time_threshold_;
+	std::atomic<bool> is_canceled_;
 
 public:
 
 	// Ԑ~bPʂŎw肵ăCX^XB
 	TimeKeeper(const int64_t& time_threshold)
 		:start_time_(std::chrono::high_resolution_clock::now()),
-		time_threshold_(time_threshold)
+		time_threshold_(time_threshold),
+		is_canceled_(false)
 	{
 
 	}
 
-	// CX^Xw肵Ԑ𒴉߂肷B
+	// CX^Xw肵Ԑ𒴉߂Afꂽ肷B
 	bool isTimeOver() const {
+		if (this->is_canceled_)return true;
 		auto diff = std::chrono::high_resolution_clock::now() - this->start_time_;
 		return std::chrono::duration_cast<std::chrono::milliseconds>(diff).count() >= time_threshold_;
 	}
 
+	// CX^X̎Ԑ~bPʂŕύXB
+	void setTimeThreshold(const int64_t time_threshold) {
+		this->time_threshold_ = time_threshold;
+	}
+
+	// Ԑ҂ɒfB
+	void cancel() {
+		this->is_canceled_ = true;
+	}
+
+};
+
+// 񓯊T̓ro
+struct SearchProgress {
+	std::atomic<Action> best_action_; // _̍őP
+	std::atomic<int64_t> iteration_; // ̐(T̐[vCAEg)
+
+	SearchProgress() :best_action_(-1), iteration_(0) {}
+
+	// ro߂XV
+	void update(const Action best_action, const int64_t iteration) {
+		this->best_action_ = best_action;
+		this->iteration_ = iteration;
+	}
+};
+
+// TƂɎyʂȗ(xoshiro128++)
+class Xoshiro128 {
+private:
+	uint32_t s_[4];
+
+	static uint32_t rotl(const uint32_t x, const int k) {
+		return (x << k) | (x >> (32 - k));
+	}
+
+public:
+	using result_type = uint32_t;
+
+	// V[hw肵ăCX^XBԂsplitmix64ŏ
+	explicit Xoshiro128(uint64_t seed = 0) {
+		for (int i = 0; i < 4; i += 2) {
+			uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			z ^= z >> 31;
+			this->s_[i] = (uint32_t)z;
+			this->s_[i + 1] = (uint32_t)(z >> 32);
+		}
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return UINT32_MAX; }
+
+	result_type operator()() {
+		const uint32_t result = rotl(this->s_[0] + this->s_[3], 7) + this->s_[0];
+		const uint32_t t = this->s_[1] << 9;
+		this->s_[2] ^= this->s_[0];
+		this->s_[3] ^= this->s_[1];
+		this->s_[1] ^= this->s_[2];
+		this->s_[0] ^= this->s_[3];
+		this->s_[2] ^= t;
+		this->s_[3] = rotl(this->s_[3], 11);
+		return result;
+	}
+};
+
+// ~Q[̔Ֆʂ8ʂ̑Ώ̕ϊ(]Ɣ])̕\\
+struct TicTacToeSymmetryTable {
+	Action squares[8][9]; // }Xi̕ϊ
+	uint16_t boards[8][512]; // rbg{[h̕ϊ
 };
 
+// Ώ̕ϊ̕\RpCɌvZ
+// ϊs̓rbg2œ]uArbg1ŏ㉺]Arbg0ōE]\
+constexpr TicTacToeSymmetryTable makeTicTacToeSymmetryTable() {
+	TicTacToeSymmetryTable table{};
+	for (int s = 0; s < 8; s++) {
+		for (int i = 0; i < 9; i++) {
+			int y = i / 3;
+			int x = i % 3;
+			if (s & 4) {
+				const int tmp = y; y = x; x = tmp;
+			}
+			if (s & 2)y = 2 - y;
+			if (s & 1)x = 2 - x;
+			table.squares[s][i] = y * 3 + x;
+		}
+		for (int board = 0; board < 512; board++) {
+			uint16_t transformed = 0;
+			for (int i = 0; i < 9; i++) {
+				if (board >> i & 1)transformed |= (uint16_t)(1 << table.squares[s][i]);
+			}
+			table.boards[s][board] = transformed;
+		}
+	}
+	return table;
+}
+constexpr const TicTacToeSymmetryTable TIC_TAC_TOE_SYMMETRY_TABLE = makeTicTacToeSymmetryTable();
+
 // ݓlQ[̗
 // ~Q[
+// Ֆʂ̓}XiiԖڂ̃rbgƂrbg{[hŎ
 class TicTacToeState {
-private:
-	std::vector<int>pieces_;
-	std::vector<int>enemy_pieces_;
+public:
+	static constexpr const int MAX_ACTION_NUMBER = 9; // 1^[ɉ\ȍs̍ő吔
+	static constexpr const uint16_t BOARD_MASK = 0x1ff; // ՖʑŜ̃}X
+	static constexpr const int SYMMETRY_NUMBER = 8; // Ֆʂ̑Ώ̕ϊ̐
+	static constexpr const uint64_t STATE_INDEX_NUMBER = 1 << 18; // stateIndex肤l̐
+	static constexpr const uint16_t LINE_MASKS[8] = { // 3ڕтɂȂ}X̑g
+		0x007, 0x038, 0x1c0, // 
+		0x049, 0x092, 0x124, // c
+		0x111, 0x054, // ΂
+	};
 
-	//̐vZ
-	int pieceCount(const std::vector<int>& pieces) const {
-		int count = 0;
-		for (const auto i : pieces) {
-			if (i == 1)++count;
+	// }Xiʂ3ڕт̑gB4gɖȂ}X́A΂uȂrbg9(0x200)Ŗ߂ĕȂŒׂ
+	static constexpr const uint16_t SQUARE_LINE_MASKS[9][4] = {
+		{ 0x007, 0x049, 0x111, 0x200 }, { 0x007, 0x092, 0x200, 0x200 }, { 0x007, 0x124, 0x054, 0x200 },
+		{ 0x038, 0x049, 0x200, 0x200 }, { 0x038, 0x092, 0x111, 0x054 }, { 0x038, 0x124, 0x200, 0x200 },
+		{ 0x1c0, 0x049, 0x054, 0x200 }, { 0x1c0, 0x092, 0x200, 0x200 }, { 0x1c0, 0x124, 0x111, 0x200 },
+	};
+
+	// ΂̔zu3ڕт܂ނ肷
+	static bool isComplete(const uint16_t pieces) {
+		for (const auto line : LINE_MASKS) {
+			if ((pieces & line) == line)return true;
 		}
-		return count;
+		return false;
 	}
 
-	//G3ڕ񂾂肷
-	bool enemyIsComplete(int x, int y, const int dx, const int dy)const {
-		for (int k = 0; k < 3; k++) {
-			if (y < 0 || 2 < y || x < 0 || 2 < x ||
-				this->enemy_pieces_[x + y * 3] == 0
-				)return false;
-			x += dx; y += dy;
+	// }Xsquareʂ3ڕтłĂ邩肷
+	static bool isCompleteAround(const uint16_t pieces, const Action square) {
+		bool is_complete = false;
+		for (int i = 0; i < 4; i++) {
+			const uint16_t line = SQUARE_LINE_MASKS[square][i];
+			is_complete |= (pieces & line) == line;
 		}
-		return true;
+		return is_complete;
+	}
+
+private:
+	uint16_t pieces_;
+	uint16_t enemy_pieces_;
+	bool is_lose_; // ̐΂3ڕł邩BadvanceōŌɒu΂̎肾ׂčXV
+
+	//̐vZ
+	static int pieceCount(const uint16_t pieces) {
+		return __builtin_popcount(pieces);
 	}
 
 	//݂̃vC[ł邩肷
@@ -72,13 +217,24 @@ private:
 	}
 public:
 	TicTacToeState(
-		const std::vector<int>& pieces = std::vector<int>(9),
-		const std::vector<int>& enemy_pieces = std::vector<int>(9)
+		const uint16_t pieces = 0,
+		const uint16_t enemy_pieces = 0
 	) :
 		pieces_(pieces),
-		enemy_pieces_(enemy_pieces)
+		enemy_pieces_(enemy_pieces),
+		is_lose_(isComplete(enemy_pieces))
 	{	}
 
+	// ݂̃vC[̐΂̃rbg{[hԂ
+	uint16_t pieces()const {
+		return this->pieces_;
+	}
+
+	// ̃vC[̐΂̃rbg{[hԂ
+	uint16_t enemyPieces()const {
+		return this->enemy_pieces_;
+	}
+
 	// [ǂ̃Q[ł] : ݂̃vC[_̔Ֆʕ]
 	ScoreType getScore()const {
 		if (this->isLose())return -1;
@@ -89,17 +245,12 @@ public:
 
 	// [ǂ̃Q[ł] : ݂̃vC[肷
 	bool isLose()const {
-		if (enemyIsComplete(0, 0, 1, 1) || enemyIsComplete(0, 2, 1, -1))return true;
-		for (int i = 0; i < 3; i++) {
-			if (enemyIsComplete(0, i, 1, 0) || enemyIsComplete(i, 0, 0, 1))
-				return true;
-		}
-		return false;
+		return this->is_lose_;
 	}
 
 	// [ǂ̃Q[ł] : ɂȂ肷
 	bool isDraw()const {
-		return this->pieceCount(this->pieces_) + this->pieceCount(this->enemy_pieces_) == 9;
+		return (this->pieces_ | this->enemy_pieces_) == BOARD_MASK;
 	}
 
 	// [ǂ̃Q[ł] : Q[I肷
@@ -109,22 +260,110 @@ public:
 
 	// [ǂ̃Q[ł] : w肵actionŃQ[1^[i߁ÃvC[_̔Ֆʂɂ
 	void advance(const Action action) {
-		this->pieces_[action] = 1;
+		this->pieces_ |= (uint16_t)(1 << action);
+		this->is_lose_ = isCompleteAround(this->pieces_, action);
 		std::swap(this->pieces_, this->enemy_pieces_);
-
 	}
 
 	// [ǂ̃Q[ł] : ݂̃vC[\ȍsSĎ擾
 	Actions legalActions()const {
 		Actions actions;
+		const uint16_t empty = ~(this->pieces_ | this->enemy_pieces_) & BOARD_MASK;
 		for (Action i = 0; i < 9; i++) {
-			if (this->pieces_[i] == 0 && this->enemy_pieces_[i] == 0) {
+			if (empty >> i & 1) {
 				actions.emplace_back(i);
 			}
 		}
 		return actions;
 	}
 
+	// [ǂ̃Q[ł] : ݂̃vC[\ȍsq[vg킸actions֏݁A̐Ԃ
+	int legalActions(Action* actions)const {
+		int action_number = 0;
+		uint16_t empty = ~(this->pieces_ | this->enemy_pieces_) & BOARD_MASK;
+		while (empty) {
+			actions[action_number++] = __builtin_ctz(empty);
+			empty &= empty - 1;
+		}
+		return action_number;
+	}
+
+	// [ǂ̃Q[ł] : \ȍŝAՖʂ̑Ώ̐œǖʂɐiނ̂1ɂ܂Ƃ߂Ď擾
+	// Ώ̐ȂQ[łlegalActionsƓł悢
+	Actions uniqueLegalActions()const {
+		Action actions[MAX_ACTION_NUMBER];
+		const int action_number = this->uniqueLegalActions(actions);
+		return Actions(actions, actions + action_number);
+	}
+
+	// [ǂ̃Q[ł] : Ֆʂ̑Ώ̐œǖʂɐiލs1ɂ܂Ƃ߂actions֏݁A̐Ԃ
+	// ǖʂ𓮂ȂΏ̕ϊňڂ荇ŝAŏ̔ԍ̂̂c
+	int uniqueLegalActions(Action* actions)const {
+		const auto& table = TIC_TAC_TOE_SYMMETRY_TABLE;
+		int symmetries[SYMMETRY_NUMBER];
+		int symmetry_number = 0;
+		for (int s = 1; s < SYMMETRY_NUMBER; s++) {
+			if (table.boards[s][this->pieces_] == this->pieces_ && table.boards[s][this->enemy_pieces_] == this->enemy_pieces_)
+				symmetries[symmetry_number++] = s;
+		}
+		const int action_number = this->legalActions(actions);
+		if (symmetry_number == 0)return action_number;
+		int unique_action_number = 0;
+		for (int i = 0; i < action_number; i++) {
+			const Action action = actions[i];
+			bool is_representative = true;
+			for (int k = 0; k < symmetry_number; k++) {
+				if (table.squares[symmetries[k]][action] < action) {
+					is_representative = false;
+					break;
+				}
+			}
+			if (is_representative)actions[unique_action_number++] = action;
+		}
+		return unique_action_number;
+	}
+
+	// [ȂĂ悢ƕ֗] : ]Ɣ]œꎋǖʂ̃L[ԂBu\̃L[Ɏg
+	uint32_t canonicalKey()const {
+		const auto& table = TIC_TAC_TOE_SYMMETRY_TABLE;
+		uint32_t key = UINT32_MAX;
+		for (int s = 0; s < SYMMETRY_NUMBER; s++) {
+			key = std::min(key, (uint32_t)table.boards[s][this->pieces_] << 9 | table.boards[s][this->enemy_pieces_]);
+		}
+		return key;
+	}
+
+	// [ȂĂ悢ƕ֗] : ̔ՖʂotherɈڂΏ̕ϊ̔ԍԂBڂȂ-1Ԃ
+	int symmetryTo(const TicTacToeState& other)const {
+		const auto& table = TIC_TAC_TOE_SYMMETRY_TABLE;
+		for (int s = 0; s < SYMMETRY_NUMBER; s++) {
+			if (table.boards[s][this->pieces_] == other.pieces_ && table.boards[s][this->enemy_pieces_] == other.enemy_pieces_)
+				return s;
+		}
+		return -1;
+	}
+
+	// [ȂĂ悢ƕ֗] : sΏ̕ϊsymmetryňڂsԂ
+	static Action transformAction(const Action action, const int symmetry) {
+		return TIC_TAC_TOE_SYMMETRY_TABLE.squares[symmetry][action];
+	}
+
+	// [ȂĂ悢ƕ֗] : wKf[^ɏoՖʂ̃oCgԂ
+	int encodedSize()const {
+		return 2 * sizeof(uint16_t);
+	}
+
+	// [ȂĂ悢ƕ֗] : wKf[^ɏo߁Ã݂vC[Ƒ̐΂̔zubytesɏ
+	void encode(uint8_t* bytes)const {
+		std::memcpy(bytes, &this->pieces_, sizeof(uint16_t));
+		std::memcpy(bytes + sizeof(uint16_t), &this->enemy_pieces_, sizeof(uint16_t));
+	}
+
+	// [ȂĂ悢ƕ֗] : ǖʂ0ȏSTATE_INDEX_NUMBER̔ԍɂBIՃf[^x[X̓YɎg
+	uint64_t stateIndex()const {
+		return this->canonicalKey();
+	}
+
 	// [ȂĂ悢ƕ֗] : ݂̃vC[̏vẐ߂̃XRAvZ
 	double getFirstPlayerScoreForWinRate() const {
 		if (this->isLose()) {
@@ -139,6 +378,11 @@ public:
 		else return 0.5;
 	}
 
+	// [ȂĂ悢ƕ֗] : Ֆʂ肷
+	bool operator==(const TicTacToeState& other)const {
+		return this->pieces_ == other.pieces_ && this->enemy_pieces_ == other.enemy_pieces_;
+	}
+
 	// [ȂĂ悢ƕ֗] : ݂̃Q[󋵂𕶎ɂ
 	std::string toString()const {
 		std::stringstream ss;
@@ -148,9 +392,9 @@ public:
 			std::pair<char, char>{ 'o', 'x' };
 		ss << "player: " << ox.first << std::endl;
 		for (int i = 0; i < 9; i++) {
-			if (this->pieces_[i] == 1)
+			if (this->pieces_ >> i & 1)
 				ss << ox.first;
-			else if (this->enemy_pieces_[i] == 1)
+			else if (this->enemy_pieces_ >> i & 1)
 				ss << ox.second;
 			else
 				ss << '_';
@@ -162,7 +406,379 @@ public:
 	}
 };
 
-using State = TicTacToeState;
+// ݓlQ[̗
+// HAW̔ՖʂKׂ珟m,n,kQ[(15,15,5Ȃܖڕ)
+// Ֆʂ̓}Xy*W+xrbgƂ64bit̔zŎAs͍Ōɒu΂̎肾Ŕ肷
+template <int H, int W, int K>
+class MnkGameState {
+public:
+	static constexpr const int MAX_ACTION_NUMBER = H * W; // 1^[ɉ\ȍs̍ő吔
+	static constexpr const int WORD_NUMBER = (H * W + 63) / 64; // rbg{[h64bit̐
+
+private:
+	using Bitboard = std::array<uint64_t, WORD_NUMBER>;
+	static constexpr const int DY[4] = { 0, 1, 1, 1 }; // т𒲂ׂ
+	static constexpr const int DX[4] = { 1, 0, 1, -1 };
+
+	Bitboard pieces_;
+	Bitboard enemy_pieces_;
+	int piece_number_; // Ֆʂ̐΂̐
+	bool is_lose_; // O̍ső肪Kׂ
+
+	static bool test(const Bitboard& board, const int square) {
+		return board[square >> 6] >> (square & 63) & 1;
+	}
+
+	// squareɒu΂܂Kȏ񂾂肷
+	static bool isCompleteAround(const Bitboard& board, const int square) {
+		const int y = square / W;
+		const int x = square % W;
+		for (int d = 0; d < 4; d++) {
+			int count = 1;
+			for (int sign = -1; sign <= 1; sign += 2) {
+				int ty = y + sign * DY[d];
+				int tx = x + sign * DX[d];
+				while (ty >= 0 && ty < H && tx >= 0 && tx < W && test(board, ty * W + tx)) {
+					count++;
+					ty += sign * DY[d];
+					tx += sign * DX[d];
+				}
+			}
+			if (count >= K)return true;
+		}
+		return false;
+	}
+
+	//݂̃vC[ł邩肷
+	bool isFirstPlayer()const {
+		return this->piece_number_ % 2 == 0;
+	}
+
+public:
+	MnkGameState() :
+		pieces_{},
+		enemy_pieces_{},
+		piece_number_(0),
+		is_lose_(false)
+	{	}
+
+	// [ǂ̃Q[ł] : ݂̃vC[_̔Ֆʕ]
+	ScoreType getScore()const {
+		if (this->isLose())return -1;
+		if (this->isDraw())return 0;
+
+		return 0; // ̂ĂȂԂł̕]̂Hv̗]n
+	}
+
+	// [ǂ̃Q[ł] : ݂̃vC[肷
+	bool isLose()const {
+		return this->is_lose_;
+	}
+
+	// [ǂ̃Q[ł] : ɂȂ肷
+	bool isDraw()const {
+		return this->piece_number_ == H * W;
+	}
+
+	// [ǂ̃Q[ł] : Q[I肷
+	bool isDone()const {
+		return this->isLose() || this->isDraw();
+	}
+
+	// [ǂ̃Q[ł] : w肵actionŃQ[1^[i߁ÃvC[_̔Ֆʂɂ
+	void advance(const Action action) {
+		this->pieces_[action >> 6] |= 1ULL << (action & 63);
+		this->is_lose_ = isCompleteAround(this->pieces_, action);
+		this->piece_number_++;
+		std::swap(this->pieces_, this->enemy_pieces_);
+	}
+
+	// [ǂ̃Q[ł] : ݂̃vC[\ȍsSĎ擾
+	Actions legalActions()const {
+		Action actions[MAX_ACTION_NUMBER];
+		const int action_number = this->legalActions(actions);
+		return Actions(actions, actions + action_number);
+	}
+
+	// [ǂ̃Q[ł] : ݂̃vC[\ȍsq[vg킸actions֏݁A̐Ԃ
+	int legalActions(Action* actions)const {
+		int action_number = 0;
+		for (int i = 0; i < WORD_NUMBER; i++) {
+			uint64_t empty = ~(this->pieces_[i] | this->enemy_pieces_[i]);
+			if (i == WORD_NUMBER - 1 && H * W % 64 != 0)
+				empty &= (1ULL << (H * W % 64)) - 1;
+			while (empty) {
+				actions[action_number++] = i * 64 + __builtin_ctzll(empty);
+				empty &= empty - 1;
+			}
+		}
+		return action_number;
+	}
+
+	// [ǂ̃Q[ł] : \ȍŝAՖʂ̑Ώ̐œǖʂɐiނ̂1ɂ܂Ƃ߂Ď擾
+	// ՖʂLΏ̂ȋǖʂ͂قڌȂ߁A܂Ƃ߂legalActionsƓ̂Ԃ
+	Actions uniqueLegalActions()const {
+		return this->legalActions();
+	}
+
+	// [ǂ̃Q[ł] : Ֆʂ̑Ώ̐œǖʂɐiލs1ɂ܂Ƃ߂actions֏݁A̐Ԃ
+	int uniqueLegalActions(Action* actions)const {
+		return this->legalActions(actions);
+	}
+
+	// [ȂĂ悢ƕ֗] : ̔ՖʂotherɈڂΏ̕ϊ̔ԍԂBڂȂ-1Ԃ
+	// Ώ̐ł܂Ƃ߂Ȃ̂ŁAՖʂ̂Ƃ̍Pϊ0Ԃ
+	int symmetryTo(const MnkGameState& other)const {
+		return *this == other ? 0 : -1;
+	}
+
+	// [ȂĂ悢ƕ֗] : sΏ̕ϊsymmetryňڂsԂ
+	static Action transformAction(const Action action, const int) {
+		return action;
+	}
+
+	// [ȂĂ悢ƕ֗] : ݂̃vC[̏vẐ߂̃XRAvZ
+	double getFirstPlayerScoreForWinRate() const {
+		if (this->isLose()) {
+			if (this->isFirstPlayer()) {
+				return 0.;
+			}
+			else {
+				return 1.;
+			}
+
+		}
+		else return 0.5;
+	}
+
+	// [ȂĂ悢ƕ֗] : wKf[^ɏoՖʂ̃oCgԂ
+	int encodedSize()const {
+		return 2 * sizeof(Bitboard);
+	}
+
+	// [ȂĂ悢ƕ֗] : wKf[^ɏo߁Ã݂vC[Ƒ̐΂̔zubytesɏ
+	void encode(uint8_t* bytes)const {
+		std::memcpy(bytes, this->pieces_.data(), sizeof(Bitboard));
+		std::memcpy(bytes + sizeof(Bitboard), this->enemy_pieces_.data(), sizeof(Bitboard));
+	}
+
+	// [ȂĂ悢ƕ֗] : Ֆʂ肷
+	bool operator==(const MnkGameState& other)const {
+		return this->pieces_ == other.pieces_ && this->enemy_pieces_ == other.enemy_pieces_;
+	}
+
+	// [ȂĂ悢ƕ֗] : ݂̃Q[󋵂𕶎ɂ
+	std::string toString()const {
+		std::stringstream ss;
+		std::pair<char, char> ox =
+			this->isFirstPlayer() ?
+			std::pair<char, char>{ 'x', 'o' } :
+			std::pair<char, char>{ 'o', 'x' };
+		ss << "player: " << ox.first << std::endl;
+		for (int i = 0; i < H * W; i++) {
+			if (test(this->pieces_, i))
+				ss << ox.first;
+			else if (test(this->enemy_pieces_, i))
+				ss << ox.second;
+			else
+				ss << '_';
+			if (i % W == W - 1)
+				ss << std::endl;
+		}
+
+		return ss.str();
+	}
+};
+
+// ]֐̓́uǂ̃vC[̐΂Aǂ̃}Xɂ邩v2*SQUARE_NUMBERʂ
+// ݐϒl͎Ԃ̃vC[猩(̐΂̐΂)ƂɁAƌ2_
+// d݂̓eLXgt@C󔒋؂̎œǂݍ݁Aǂݍނ܂ł͑S0
+
+// `]֐
+template <int SQUARE_NUMBER>
+class LinearEvaluator {
+public:
+	struct Accumulator {
+		float values[2]; // 莋_ƌ莋_̏d݂̘a
+	};
+
+private:
+	static inline float weights_[2 * SQUARE_NUMBER] = {}; // [̐΂̐΂][}X]
+	static inline float bias_ = 0;
+
+public:
+	static constexpr const int WEIGHT_NUMBER = 2 * SQUARE_NUMBER + 1; // t@Cɏd݂̐
+
+	// ΂1ȂՖʂ̗ݐϒlԂ
+	static Accumulator initialAccumulator() {
+		return Accumulator{ { bias_, bias_ } };
+	}
+
+	// playersquareɐ΂uƂ̗ݐϒl̍
+	static void addPiece(Accumulator* accumulator, const int player, const int square) {
+		for (int perspective = 0; perspective < 2; perspective++) {
+			accumulator->values[perspective] += weights_[(player == perspective ? 0 : SQUARE_NUMBER) + square];
+		}
+	}
+
+	// Ԃ̃vC[猩]l-11͈̔͂ŕԂ
+	static float evaluate(const Accumulator& accumulator, const int player) {
+		return std::min(1.f, std::max(-1.f, accumulator.values[player]));
+	}
+
+	// d݂u̐΂̏d݁A̐΂̏d݁AoCAXv̏ɓǂݍ
+	static void load(const std::string& path) {
+		std::ifstream ifs(path);
+		float weights[WEIGHT_NUMBER];
+		for (auto& weight : weights) {
+			if (!(ifs >> weight))throw std::string("cannot read weights from ") + path;
+		}
+		std::copy(weights, weights + 2 * SQUARE_NUMBER, weights_);
+		bias_ = weights[2 * SQUARE_NUMBER];
+	}
+};
+
+// Bw1wNNUE]֐
+// d݂͓ǂݍݎ16bitɗʎqAݐϒl̍XVƏo͑w̓ς𐮐̌Œ蒷[vŏSIMD
+// ݐϒl͐΂̂}XSĂ̏d݂̘aɂȂA15x15̔Ֆʂł16bitɎ܂Ȃ̂32bitŎ
+template <int SQUARE_NUMBER, int HIDDEN_NUMBER = 16>
+class NnueEvaluator {
+public:
+	struct Accumulator {
+		alignas(32) int32_t values[2][HIDDEN_NUMBER]; // 莋_ƌ莋_̉Bw̓
+	};
+
+private:
+	static constexpr const int HIDDEN_SCALE = 127; // Bw̗ʎq̔{B͂̒lœłɂ
+	static constexpr const int OUTPUT_SCALE = 64; // o͑w̏d݂̗ʎq̔{
+
+	alignas(32) static inline int16_t feature_weights_[2 * SQUARE_NUMBER][HIDDEN_NUMBER] = {};
+	alignas(32) static inline int16_t hidden_biases_[HIDDEN_NUMBER] = {};
+	alignas(32) static inline int16_t output_weights_[2][HIDDEN_NUMBER] = {}; // [ԑ葤][Bw]
+	static inline int32_t output_bias_ = 0;
+
+	static int16_t quantize(const float value, const int scale) {
+		return (int16_t)std::min(32767.f, std::max(-32767.f, std::round(value * scale)));
+	}
+
+public:
+	static constexpr const int WEIGHT_NUMBER = 2 * SQUARE_NUMBER * HIDDEN_NUMBER + HIDDEN_NUMBER + 2 * HIDDEN_NUMBER + 1; // t@Cɏd݂̐
+
+	// ΂1ȂՖʂ̗ݐϒlԂ
+	static Accumulator initialAccumulator() {
+		Accumulator accumulator;
+		for (int perspective = 0; perspective < 2; perspective++) {
+			std::copy(hidden_biases_, hidden_biases_ + HIDDEN_NUMBER, accumulator.values[perspective]);
+		}
+		return accumulator;
+	}
+
+	// playersquareɐ΂uƂ̗ݐϒl̍
+	static void addPiece(Accumulator* accumulator, const int player, const int square) {
+		for (int perspective = 0; perspective < 2; perspective++) {
+			const int16_t* weights = feature_weights_[(player == perspective ? 0 : SQUARE_NUMBER) + square];
+			int32_t* values = accumulator->values[perspective];
+			for (int h = 0; h < HIDDEN_NUMBER; h++) {
+				values[h] += weights[h];
+			}
+		}
+	}
+
+	// Ԃ̃vC[猩]l-11͈̔͂ŕԂ
+	static float evaluate(const Accumulator& accumulator, const int player) {
+		int32_t sum = output_bias_;
+		for (int side = 0; side < 2; side++) {
+			const int32_t* values = accumulator.values[side == 0 ? player : 1 - player];
+			const int16_t* weights = output_weights_[side];
+			for (int h = 0; h < HIDDEN_NUMBER; h++) {
+				const int32_t activation = std::min<int32_t>(HIDDEN_SCALE, std::max<int32_t>(0, values[h]));
+				sum += activation * weights[h];
+			}
+		}
+		const float value = (float)sum / (HIDDEN_SCALE * OUTPUT_SCALE);
+		return std::min(1.f, std::max(-1.f, value));
+	}
+
+	// d݂uBwւ̏d[̐΂̐΂][}X][Bw]ABw̃oCAXA
+	// o͑w̏d[ԑ葤][Bw]Ao͑w̃oCAXv̏ɓǂݍ
+	static void load(const std::string& path) {
+		std::ifstream ifs(path);
+		auto weights = std::vector<float>(WEIGHT_NUMBER);
+		for (auto& weight : weights) {
+			if (!(ifs >> weight))throw std::string("cannot read weights from ") + path;
+		}
+		auto it = weights.begin();
+		for (auto& feature_weights : feature_weights_) {
+			for (auto& weight : feature_weights)weight = quantize(*it++, HIDDEN_SCALE);
+		}
+		for (auto& bias : hidden_biases_)bias = quantize(*it++, HIDDEN_SCALE);
+		for (auto& side_weights : output_weights_) {
+			for (auto& weight : side_weights)weight = quantize(*it++, OUTPUT_SCALE);
+		}
+		output_bias_ = (int32_t)std::round(*it++ * HIDDEN_SCALE * OUTPUT_SCALE);
+	}
+};
+
+// BaseStateɁA΂uтɕ]֐̗ݐϒlXV@\𑫂Ֆ
+// ̂ĂȂǖʂgetScoreŕ]֐̒lԂ
+template <class BaseState, class Evaluator>
+class EvaluatedState : public BaseState {
+public:
+	static constexpr const ScoreType EVALUATION_SCALE = 1000; // ̋ǖʂ̃XRAB]֐̒l͂菬Βlɂ
+
+private:
+	typename Evaluator::Accumulator accumulator_;
+	int player_; // Ԃ̃vC[B0Ȃ
+
+public:
+	EvaluatedState() :
+		BaseState(),
+		accumulator_(Evaluator::initialAccumulator()),
+		player_(0)
+	{	}
+
+	// [ǂ̃Q[ł] : ݂̃vC[_̔Ֆʕ]
+	ScoreType getScore()const {
+		if (this->isLose())return -EVALUATION_SCALE;
+		if (this->isDraw())return 0;
+
+		return (ScoreType)(Evaluator::evaluate(this->accumulator_, this->player_) * (EVALUATION_SCALE - 1));
+	}
+
+	// [ǂ̃Q[ł] : w肵actionŃQ[1^[i߁ÃvC[_̔Ֆʂɂ
+	void advance(const Action action) {
+		Evaluator::addPiece(&this->accumulator_, this->player_, action);
+		BaseState::advance(action);
+		this->player_ ^= 1;
+	}
+};
+
+// MNK_GAME`ăRpCm,n,kQ[ŒTBՖʂ̑傫 MNK_H, MNK_W, MNK_K ŕς
+#ifdef MNK_GAME
+#ifndef MNK_H
+#define MNK_H 15
+#endif
+#ifndef MNK_W
+#define MNK_W 15
+#endif
+#ifndef MNK_K
+#define MNK_K 5
+#endif
+using PlainState = MnkGameState<MNK_H, MNK_W, MNK_K>;
+#else
+using PlainState = TicTacToeState;
+#endif
+
+// LINEAR_EVALUATORNNUE_EVALUATOR`ăRpCƁA]֐̔ՖʂŒT
+#if defined(NNUE_EVALUATOR)
+using Evaluator = NnueEvaluator<PlainState::MAX_ACTION_NUMBER>;
+using State = EvaluatedState<PlainState, Evaluator>;
+#elif defined(LINEAR_EVALUATOR)
+using Evaluator = LinearEvaluator<PlainState::MAX_ACTION_NUMBER>;
+using State = EvaluatedState<PlainState, Evaluator>;
+#else
+using State = PlainState;
+#endif
 
 // _ɍs肷
 Action randomAction(const State& state) {
@@ -170,13 +786,20 @@ Action randomAction(const State& state) {
 	return legal_actions[mt() % (legal_actions.size())];
 }
 
+// TƂ̗gAq[vg킸Ƀ_ɍs肷
+Action randomAction(const State& state, Xoshiro128& rng) {
+	Action legal_actions[State::MAX_ACTION_NUMBER];
+	const int action_number = state.legalActions(legal_actions);
+	return legal_actions[rng() % action_number];
+}
+
 namespace minimax {
 	// minimax̂߂̃XRAvZ
 	ScoreType miniMaxScore(const State& state, const int depth) {
 		if (state.isDone() || depth == 0) {
 			return state.getScore();
 		}
-		auto legal_actions = state.legalActions();
+		auto legal_actions = state.uniqueLegalActions();
 		if (legal_actions.empty()) {
 			return state.getScore();
 		}
@@ -195,7 +818,7 @@ namespace minimax {
 	Action miniMaxAction(const State& state, const int depth) {
 		ScoreType best_action = -1;
 		ScoreType best_score = -INF;
-		for (const auto action : state.legalActions()) {
+		for (const auto action : state.uniqueLegalActions()) {
 			State next_state = state;
 			next_state.advance(action);
 			ScoreType score = -miniMaxScore(next_state, depth);
@@ -215,7 +838,7 @@ namespace alphabeta {
 		if (state.isDone() || depth == 0) {
 			return state.getScore();
 		}
-		auto legal_actions = state.legalActions();
+		auto legal_actions = state.uniqueLegalActions();
 		if (legal_actions.empty()) {
 			return state.getScore();
 		}
@@ -236,7 +859,7 @@ namespace alphabeta {
 	Action alphaBetaAction(const State& state, const int depth) {
 		ScoreType best_action = -1;
 		ScoreType alpha = -INF;
-		for (const auto action : state.legalActions()) {
+		for (const auto action : state.uniqueLegalActions()) {
 			State next_state = state;
 			next_state.advance(action);
 			ScoreType score = -alphaBetaScore(next_state, -INF, -alpha, depth);
@@ -259,7 +882,7 @@ namespace iterativedeepning {
 		if (state.isDone() || depth == 0) {
 			return state.getScore();
 		}
-		auto legal_actions = state.legalActions();
+		auto legal_actions = state.uniqueLegalActions();
 		if (legal_actions.empty()) {
 			return state.getScore();
 		}
@@ -281,7 +904,7 @@ namespace iterativedeepning {
 	Action alphaBetaActionWithTimeThreshold(const State& state, const int depth, const TimeKeeper& time_keeper) {
 		ScoreType best_action = -1;
 		ScoreType alpha = -INF;
-		for (const auto action : state.legalActions()) {
+		for (const auto action : state.uniqueLegalActions()) {
 			State next_state = state;
 			next_state.advance(action);
 			ScoreType score = -alphaBetaScore(next_state, -INF, -alpha, depth, time_keeper);
@@ -294,9 +917,8 @@ namespace iterativedeepning {
 		return best_action;
 	}
 
-	// (ms)w肵Ĕ[ōs肷
-	Action iterativeDeepningAction(const State& state, const int64_t time_threshold) {
-		auto time_keeper = TimeKeeper(time_threshold);
+	// time_keeper~߂܂Ŕ[ŒTA[Ƃ̍őPprogressɏ
+	Action iterativeDeepningActionWithTimeKeeper(const State& state, const TimeKeeper& time_keeper, SearchProgress* progress = nullptr) {
 		Action best_action = -1;
 		for (int depth = 1;; depth++) {
 			Action action = alphaBetaActionWithTimeThreshold(state, depth, time_keeper);
@@ -307,12 +929,197 @@ namespace iterativedeepning {
 			}
 			else {
 				best_action = action;
+				if (progress != nullptr)
+					progress->update(best_action, depth);
 			}
 		}
 		return best_action;
 	}
+
+	// (ms)w肵Ĕ[ōs肷
+	Action iterativeDeepningAction(const State& state, const int64_t time_threshold) {
+		auto time_keeper = TimeKeeper(time_threshold);
+		return iterativeDeepningActionWithTimeKeeper(state, time_keeper);
+	}
 }
 using iterativedeepning::iterativeDeepningAction;
+using iterativedeepning::iterativeDeepningActionWithTimeKeeper;
+
+// Sǖʂ̏s߂IՃf[^x[X
+// STATE_INDEX_NUMBERstateIndexQ[Ȃǂł
+namespace endgametable {
+	// Ԃ̃vC[猩ǖʂ̒lB1ǖʂ2bitŕۑ
+	enum Value : uint8_t {
+		UNKNOWN = 0, // 
+		LOSS = 1,
+		DRAW = 2,
+		WIN = 3,
+	};
+
+	// qǖʂ̒lA̋ǖʂɐi߂vC[猩lԂ
+	// ͂̋ǖʂUNKNOWN̂܂ܕԂ̂ŁAׂƕ舫lƂĈ
+	Value parentValue(const Value child_value) {
+		if (child_value == UNKNOWN)return UNKNOWN;
+		return (Value)(4 - child_value);
+	}
+
+	constexpr const char MAGIC[8] = "EGTB001"; // t@C`̎ʎq
+
+	// t@C̐擪ɒuwb_
+	struct Header {
+		char magic[8];
+		uint64_t index_number; // ǖʂ̔ԍ̐
+	};
+
+	// B\ȑSǖʂHAIǂkĊeǖʂ̒lm肳
+	template <class GameState>
+	class Solver {
+	private:
+		std::vector<Value> values_;
+		int64_t solved_number_;
+
+	public:
+		Solver() :values_(GameState::STATE_INDEX_NUMBER, UNKNOWN), solved_number_(0) {}
+
+		// state瓞BłSǖʂ͂Astate̒lԂ
+		// Ώ̂Ȏqǖʂ1HAxm肵ǖʂ͔ԍňčČvZȂ
+		Value solve(const GameState& state) {
+			const uint64_t index = state.stateIndex();
+			if (this->values_[index] != UNKNOWN)return this->values_[index];
+			Value value = LOSS;
+			if (state.isLose()) {
+				value = LOSS;
+			}
+			else if (state.isDone()) {
+				value = DRAW;
+			}
+			else {
+				Action actions[GameState::MAX_ACTION_NUMBER];
+				const int action_number = state.uniqueLegalActions(actions);
+				for (int i = 0; i < action_number; i++) {
+					GameState next_state = state;
+					next_state.advance(actions[i]);
+					value = std::max(value, parentValue(this->solve(next_state))); // ĂSĂ̎qǖʂ\ɍڂ
+				}
+			}
+			this->values_[index] = value;
+			this->solved_number_++;
+			return value;
+		}
+
+		// ͍ς݂̋ǖʐԂ
+		int64_t solvedNumber()const {
+			return this->solved_number_;
+		}
+
+		// ͌ʂ1ǖ2bitɋl߂ăt@Cɏo
+		void write(const std::string& path)const {
+			std::ofstream ofs(path, std::ios::binary);
+			if (!ofs)throw std::string("cannot open ") + path;
+			Header header{};
+			std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+			header.index_number = this->values_.size();
+			ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			auto packed = std::vector<uint8_t>((this->values_.size() + 3) / 4);
+			for (uint64_t index = 0; index < this->values_.size(); index++) {
+				packed[index >> 2] |= (uint8_t)(this->values_[index] << ((index & 3) * 2));
+			}
+			ofs.write(reinterpret_cast<const char*>(packed.data()), packed.size());
+		}
+	};
+
+	// oIՃf[^x[X}bvAǖʂ̒lO(1)ň
+	// }bvłȂł̓t@CŜǂݍ
+	template <class GameState>
+	class Table {
+	private:
+		const uint8_t* values_;
+		size_t mapped_size_;
+		void* mapped_;
+		std::vector<uint8_t> buffer_;
+
+	public:
+		// t@CJB`ႦΗO𓊂
+		// RXgN^O𓊂ƃfXgN^͌Ă΂Ȃ̂ŁA؂I܂łmmap̈[JϐŎ
+		explicit Table(const std::string& path) :values_(nullptr), mapped_size_(0), mapped_(nullptr) {
+			const size_t value_size = (GameState::STATE_INDEX_NUMBER + 3) / 4;
+			void* mapped = nullptr;
+			const uint8_t* data = nullptr;
+			size_t file_size = 0;
+#ifndef _WIN32
+			const int fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0)throw std::string("cannot open ") + path;
+			struct stat st;
+			if (fstat(fd, &st) == 0 && st.st_size > 0) {
+				void* result = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+				if (result != MAP_FAILED) {
+					mapped = result;
+					data = static_cast<const uint8_t*>(result);
+					file_size = st.st_size;
+				}
+			}
+			close(fd);
+#endif
+			if (data == nullptr) {
+				std::ifstream ifs(path, std::ios::binary);
+				if (!ifs)throw std::string("cannot open ") + path;
+				this->buffer_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+				data = this->buffer_.data();
+				file_size = this->buffer_.size();
+			}
+			// ꂽt@CȂAmmap̈ĂO𓊂
+			const auto broken = [&]() {
+#ifndef _WIN32
+				if (mapped != nullptr)
+					munmap(mapped, file_size);
+#endif
+				return std::string("broken endgame table ") + path;
+			};
+			Header header;
+			if (file_size < sizeof(header) + value_size)throw broken();
+			std::memcpy(&header, data, sizeof(header));
+			if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0 || header.index_number != GameState::STATE_INDEX_NUMBER)
+				throw broken();
+			this->mapped_ = mapped;
+			this->mapped_size_ = file_size;
+			this->values_ = data + sizeof(header);
+		}
+
+		Table(const Table&) = delete;
+		Table& operator=(const Table&) = delete;
+
+		~Table() {
+#ifndef _WIN32
+			if (this->mapped_ != nullptr)
+				munmap(this->mapped_, this->mapped_size_);
+#endif
+		}
+
+		// ǖʂ̒lԂ
+		Value probe(const GameState& state)const {
+			const uint64_t index = state.stateIndex();
+			return (Value)(this->values_[index >> 2] >> ((index & 3) * 2) & 3);
+		}
+	};
+
+	// IՃf[^x[XāAłl̗ǂs肷
+	template <class GameState>
+	Action endgameTableAction(const Table<GameState>& table, const GameState& state) {
+		Action best_action = -1;
+		Value best_value = UNKNOWN;
+		for (const auto action : state.uniqueLegalActions()) {
+			GameState next_state = state;
+			next_state.advance(action);
+			const Value value = parentValue(table.probe(next_state));
+			if (best_action < 0 || value > best_value) {
+				best_action = action;
+				best_value = value;
+			}
+		}
+		return best_action;
+	}
+}
+using endgametable::endgameTableAction;
 
 namespace montecarlo {
 	// z̍ől̃CfbNXԂ
@@ -320,26 +1127,99 @@ namespace montecarlo {
 		return std::distance(x.begin(), std::max_element(x.begin(), x.end()));
 	}
 	// _vCAEgďsXRAvZ
-	double playout(State* state) { // const&ɂƍċAɃfB[vRs[KvɂȂ邽߁Â߃|C^ɂB(constłȂQƂł)
-		if (state->isLose())
-			return 0;
-		if (state->isDraw())
-			return 0.5;
-		state->advance(randomAction(*state));
-		return 1. - playout(state);
+	// ċAɃ[vŐi߁Aq[vmۂȂ
+	double playout(State* state, Xoshiro128& rng) { // const&ɂƃfB[vRs[KvɂȂ邽߁Â߃|C^ɂB(constłȂQƂł)
+		int depth = 0;
+		while (!state->isDone()) {
+			state->advance(randomAction(*state, rng));
+			++depth;
+		}
+		const double value = state->isLose() ? 0 : 0.5; // IǎɎԂ̃vC[_̒l
+		return depth % 2 == 0 ? value : 1. - value;
+	}
+
+	constexpr const int PLAYOUT_LANE_NUMBER = 16; // ܂Ƃ߂Đi߂vCAEg̐
+
+	// Ֆʂgame_number񃉃_vCAEgďsXRA̍vvZ
+	// rbg{[hȂQ[ł1񂸂vCAEg
+	template <class S>
+	double playoutBatch(const S& state, const int game_number, Xoshiro128& rng) {
+		double value = 0;
+		for (int i = 0; i < game_number; i++) {
+			S next_state = state;
+			value += playout(&next_state, rng);
+		}
+		return value;
+	}
+
+	// ~Q[łPLAYOUT_LANE_NUMBERǂ萔Ői߁ÂȂz񉉎ZSIMDł悤ɂ
+	double playoutBatch(const TicTacToeState& state, const int game_number, Xoshiro128& rng) {
+		constexpr int L = PLAYOUT_LANE_NUMBER;
+		double value = 0;
+		for (int begin = 0; begin < game_number; begin += L) {
+			const int lane_number = std::min(L, game_number - begin);
+			uint16_t pieces[L], enemy_pieces[L];
+			uint32_t seeds[L]; // [Ƃxorshift32̏
+			uint32_t alive[L]; // ĂȂΑSrbg1
+			uint32_t points[L]; // JnՖʂ̎Ԃ̃vC[_̏_(2,1,0)
+			for (int l = 0; l < L; l++) {
+				pieces[l] = state.pieces();
+				enemy_pieces[l] = state.enemyPieces();
+				seeds[l] = rng() | 1;
+				alive[l] = ~0u;
+				points[l] = 0;
+			}
+			for (int depth = 0; depth <= TicTacToeState::MAX_ACTION_NUMBER; depth++) {
+				const uint32_t lose_points = depth % 2 == 0 ? 0 : 2; // Ԃ̃vC[ꍇ̏_
+				for (int l = 0; l < L; l++) {
+					const uint32_t enemy = enemy_pieces[l];
+					uint32_t lose = 0;
+					for (const auto line : TicTacToeState::LINE_MASKS) {
+						lose |= (uint32_t)((enemy & line) == line);
+					}
+					const uint32_t empty = ~(pieces[l] | enemy) & TicTacToeState::BOARD_MASK;
+					const uint32_t draw = (uint32_t)(empty == 0) & (lose ^ 1);
+					points[l] += alive[l] & (((0u - lose) & lose_points) | ((0u - draw) & 1));
+					alive[l] &= (lose | draw) - 1;
+
+					// 󂫃}X̂kԖڂI
+					uint32_t x = seeds[l];
+					x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+					seeds[l] = x;
+					uint32_t count = empty - ((empty >> 1) & 0x5555);
+					count = (count & 0x3333) + ((count >> 2) & 0x3333);
+					count = (count + (count >> 4)) & 0x0f0f;
+					count = (count + (count >> 8)) & 0x1f;
+					int32_t k = (int32_t)(((uint64_t)x * count) >> 32);
+					uint32_t chosen = 0;
+					for (int b = 0; b < TicTacToeState::MAX_ACTION_NUMBER; b++) {
+						const int32_t bit = (empty >> b) & 1;
+						chosen |= (uint32_t)(bit & (k == 0)) << b;
+						k -= bit;
+					}
+					const uint16_t next_pieces = pieces[l] | (uint16_t)(chosen & alive[l]);
+					pieces[l] = enemy_pieces[l];
+					enemy_pieces[l] = next_pieces;
+				}
+			}
+			uint32_t total_points = 0;
+			for (int l = 0; l < lane_number; l++) {
+				total_points += points[l];
+			}
+			value += total_points * 0.5;
+		}
+		return value;
 	}
 	// vCAEg񐔂w肵ČneJ@ōs肷
 	Action primitiveMontecarloAction(const State& state, int playout_number) {
-		auto legal_actions = state.legalActions();
+		Xoshiro128 rng(mt());
+		auto legal_actions = state.uniqueLegalActions();
 		double best_value = -INF;
 		int best_i = -1;
 		for (int i = 0; i < legal_actions.size(); i++) {
-			double value = 0;
-			for (int j = 0; j < playout_number; j++) {
-				State next_state = state;
-				next_state.advance(legal_actions[i]);
-				value += 1. - playout(&next_state);
-			}
+			State next_state = state;
+			next_state.advance(legal_actions[i]);
+			double value = playout_number - playoutBatch(next_state, playout_number, rng);
 			if (value > best_value) {
 				best_i = i;
 				best_value = value;
@@ -350,7 +1230,8 @@ namespace montecarlo {
 	}
 	// (ms)w肵ČneJ@ōs肷
 	Action primitiveMontecarloActionWithTimeThreshold(const State& state, const int64_t time_threshold) {
-		auto legal_actions = state.legalActions();
+		Xoshiro128 rng(mt());
+		auto legal_actions = state.uniqueLegalActions();
 		double best_value = -INF;
 		int best_i = -1;
 		auto time_keeper = TimeKeeper(time_threshold);
@@ -360,7 +1241,7 @@ namespace montecarlo {
 			for (int i = 0; i < legal_actions.size(); i++) {
 				State next_state = state;
 				next_state.advance(legal_actions[i]);
-				values[i] += 1. - playout(&next_state);
+				values[i] += PLAYOUT_LANE_NUMBER - playoutBatch(next_state, PLAYOUT_LANE_NUMBER, rng);
 			}
 			if (time_keeper.isTimeOver()) {
 				break;
@@ -374,134 +1255,1262 @@ namespace montecarlo {
 	constexpr const double C = 1.; //UCB1̌vZɎg萔
 	constexpr const int EXPAND_THRESHOLD = 10; // m[hWJ臒l
 
-	// MCTŠvZɎgm[h
-	class Node {
+	// m[h̎Ԃ̃vC[_ŏؖς݂̃Q[_l
+	enum Proof : int8_t {
+		UNPROVEN,
+		PROVEN_WIN,
+		PROVEN_LOSS,
+		PROVEN_DRAW,
+	};
+
+	// T؂̑傫̏Bǂ0ȂȂ
+	struct NodeBudget {
+		int64_t max_node_number = 0; // m[h̏
+		int64_t max_byte_size = 0; // m[h̔zɎgoCg̏
+		bool recycles = false; // ɒB玎s񐔂̏Ȃ؂̂Ăċ󂫂BfalseȂWJ~߂
+	};
+
+	// T؂̃gp
+	struct TreeStatistics {
+		int64_t node_number = 0; // m[h
+		int64_t byte_size = 0; // m[h̔z񂪊mۂĂoCg
+		int64_t pruned_node_number = 0; // 󂫂邽߂Ɏ̂Ăm[h̉א
+	};
+
+	// MCTŠvZɎgT
+	// m[h͔zɘAĊi[Aqm[h͐擪CfbNXƌŕ\B
+	// Ֆʂ̓m[hɎA[g̔ՖʂsHĕB
+	// UCB1̌vZŘAǂ߂悤Am[h̓vʂ͍ڂƂ̔zɎB
+	class Tree {
 	private:
-		State state_;
-		double w_;
+		State root_state_;
+		Xoshiro128 rng_; // vCAEgp̗
+		int leaf_playout_number_; // tm[h̕]1񂠂̃vCAEg
+		std::vector<int> path_; // ]ɒHm[h̃CfbNX
+		NodeBudget budget_;
+		int64_t max_node_number_; // budget_狁߂m[h̏B0ȂȂ
+		bool needs_recycle_; // ̂ߓWJłȂm[hA̕]̑Oɋ󂫂
+		int64_t pruned_node_number_;
+
+		// em[hactionőJڂm[hǉ
+		int addNode(const Action action) {
+			this->w_.emplace_back(0);
+			this->n_.emplace_back(0);
+			this->actions_.emplace_back(action);
+			this->child_begin_.emplace_back(0);
+			this->child_size_.emplace_back(0);
+			this->proofs_.emplace_back(UNPROVEN);
+			return (int)this->n_.size() - 1;
+		}
+
+		// rootƂ镔؂̂As񐔂min_ñm[h̎q̂ĂƂɎcm[hkeptɈtA̐Ԃ
+		// [g̎q͏ɎcBem[h͎qm[hOɂ̂ŁAO1񑖍΂悢
+		int64_t markKept(const int root, const double min_n, std::vector<uint8_t>* kept) const {
+			kept->assign(this->n_.size(), 0);
+			(*kept)[root] = 1;
+			int64_t kept_number = 1;
+			for (int i = root; i < (int)this->n_.size(); i++) {
+				if (!(*kept)[i] || this->child_size_[i] == 0 || (i != root && this->n_[i] < min_n))
+					continue;
+				for (int c = 0; c < this->child_size_[i]; c++) {
+					(*kept)[this->child_begin_[i] + c] = 1;
+				}
+				kept_number += this->child_size_[i];
+			}
+			return kept_number;
+		}
+
+		// markKeptŎcm[hԂۂ܂ܔz̑Oɋl߁ArootCfbNX0ɂ
+		// l߂̃CfbNX͌̃CfbNXȉȂ̂ŁȀŏ㏑łAzmۂȂ
+		void compact(const int root, const double min_n) {
+			std::vector<uint8_t> kept;
+			const int64_t kept_number = this->markKept(root, min_n, &kept);
+			std::vector<int> new_ids(this->n_.size(), -1);
+			int next_id = 0;
+			for (int i = root; i < (int)this->n_.size(); i++) {
+				if (kept[i])
+					new_ids[i] = next_id++;
+			}
+			for (int i = root; i < (int)this->n_.size(); i++) {
+				const int id = new_ids[i];
+				if (id < 0)
+					continue;
+				const bool has_children = this->child_size_[i] > 0 && kept[this->child_begin_[i]];
+				this->w_[id] = this->w_[i];
+				this->n_[id] = this->n_[i];
+				this->actions_[id] = this->actions_[i];
+				this->proofs_[id] = this->proofs_[i];
+				this->child_begin_[id] = has_children ? new_ids[this->child_begin_[i]] : 0;
+				this->child_size_[id] = has_children ? this->child_size_[i] : 0;
+			}
+			this->pruned_node_number_ += (int64_t)this->n_.size() - kept_number;
+			this->w_.resize(kept_number);
+			this->n_.resize(kept_number);
+			this->actions_.resize(kept_number);
+			this->child_begin_.resize(kept_number);
+			this->child_size_.resize(kept_number);
+			this->proofs_.resize(kept_number);
+		}
+
+		// s񐔂̏Ȃm[h̎q̂āAm[h̔ȉɂ
+		void recycle() {
+			const int64_t target = this->max_node_number_ / 2;
+			std::vector<uint8_t> kept;
+			int64_t low = 0;
+			int64_t high = (int64_t)this->n_[0] + 1;
+			while (low < high) {
+				const int64_t mid = (low + high) / 2;
+				if (this->markKept(0, (double)mid, &kept) <= target)
+					high = mid;
+				else
+					low = mid + 1;
+			}
+			this->compact(0, (double)low);
+			this->needs_recycle_ = false;
+		}
+
 	public:
-		std::vector<Node>child_nodes;
-		double n_;
+		std::vector<double> w_;
+		std::vector<double> n_;
+		std::vector<Action> actions_; // em[h炱̃m[hɑJڂs
+		std::vector<int> child_begin_; // qm[h̐擪CfbNX
+		std::vector<int> child_size_; // qm[h̐B0Ȃ疢WJ
+		std::vector<Proof> proofs_; // ؖς݂̃Q[_l
 
-		// m[h̕]s
-		double evaluate() {
-			if (this->state_.isDone()) {
-				double value = this->state_.isLose() ? 0 : 0.5;
-				this->w_ += value;
-				++this->n_;
-				return value;
+		// 1m[h̃oCg
+		static constexpr const int64_t NODE_BYTE_SIZE = 2 * sizeof(double) + sizeof(Action) + 2 * sizeof(int) + sizeof(Proof);
+
+		Tree(const State& state, const uint64_t seed, const int leaf_playout_number = 1) :
+			root_state_(state),
+			rng_(seed),
+			leaf_playout_number_(leaf_playout_number),
+			max_node_number_(0),
+			needs_recycle_(false),
+			pruned_node_number_(0)
+		{
+			this->addNode(-1);
+		}
+
+		// T؂̑傫̏ݒ肷B̕ɔzmۂAT͊mۂȂ
+		// ėp̒T؂ɏ𒴂Ă΁As񐔂̏Ȃ؂̂āAz̑傫Ɋmۂ
+		void setNodeBudget(const NodeBudget& budget) {
+			this->budget_ = budget;
+			this->max_node_number_ = budget.max_node_number;
+			if (budget.max_byte_size > 0) {
+				const int64_t max_node_number = std::max<int64_t>(budget.max_byte_size / NODE_BYTE_SIZE, 1);
+				this->max_node_number_ = this->max_node_number_ > 0 ? std::min(this->max_node_number_, max_node_number) : max_node_number;
+			}
+			if (this->max_node_number_ > 0) {
+				if ((int64_t)this->n_.size() > this->max_node_number_)
+					this->recycle();
+				const auto reserve = [&](auto& values) {
+					if ((int64_t)values.capacity() > this->max_node_number_)
+						values.shrink_to_fit();
+					values.reserve(this->max_node_number_);
+				};
+				reserve(this->w_);
+				reserve(this->n_);
+				reserve(this->actions_);
+				reserve(this->child_begin_);
+				reserve(this->child_size_);
+				reserve(this->proofs_);
 			}
-			if (this->child_nodes.empty()) {
-				State state_copy = this->state_;
-				double value = playout(&state_copy);
-				this->w_ += value;
-				++this->n_;
+		}
 
-				if (this->n_ == EXPAND_THRESHOLD)
-					this->expand();
+		// T؂̃gpʂԂ
+		TreeStatistics statistics()const {
+			TreeStatistics statistics;
+			statistics.node_number = (int64_t)this->n_.size();
+			statistics.byte_size = (int64_t)(this->w_.capacity() * sizeof(double) + this->n_.capacity() * sizeof(double)
+				+ this->actions_.capacity() * sizeof(Action) + this->child_begin_.capacity() * sizeof(int)
+				+ this->child_size_.capacity() * sizeof(int) + this->proofs_.capacity() * sizeof(Proof));
+			statistics.pruned_node_number = this->pruned_node_number_;
+			return statistics;
+		}
 
-				return value;
+		// m[hWJAWJłԂ
+		// Ώ̂ȋǖʂɐiގqm[h1ɂ܂Ƃ߁AvL
+		// m[h̏𒴂ꍇ̓[gȊOWJȂ
+		bool expand(const int node, const State& state) {
+			auto legal_actions = state.uniqueLegalActions();
+			if (node != 0 && this->max_node_number_ > 0 && (int64_t)(this->n_.size() + legal_actions.size()) > this->max_node_number_) {
+				this->needs_recycle_ = this->budget_.recycles;
+				return false;
+			}
+			const int child_begin = (int)this->n_.size();
+			for (const auto action : legal_actions) {
+				this->addNode(action);
+			}
+			this->child_begin_[node] = child_begin;
+			this->child_size_[node] = (int)legal_actions.size();
+			return true;
+		}
+
+		// [gm[hWJBWJς݂Ȃ牽Ȃ
+		void expandRoot() {
+			if (this->child_size_[0] == 0 && !this->root_state_.isDone())
+				this->expand(0, this->root_state_);
+		}
+
+		// [gm[h̔ՖʂԂ
+		const State& rootState()const {
+			return this->root_state_;
+		}
+
+		// [gactionőJڂqm[hɐi߁AȊO̕؂
+		// c؂͓z̑Oɋlߒ̂ŁAzmۂȂ
+		void advanceRoot(const Action action) {
+			this->root_state_.advance(action);
+			const int begin = this->child_begin_[0];
+			const int end = begin + this->child_size_[0];
+			int next_root = -1;
+			for (int i = begin; i < end; i++) {
+				if (this->actions_[i] == action)
+					next_root = i;
+			}
+			if (next_root >= 0) {
+				const int64_t pruned_node_number = this->pruned_node_number_;
+				this->compact(next_root, 0);
+				this->pruned_node_number_ = pruned_node_number; // ԂiŕsvɂȂm[h͐Ȃ
 			}
 			else {
-				double value = 1. - this->nextChiledNode().evaluate();
-				this->w_ += value;
-				++this->n_;
-				return value;
+				this->w_.clear();
+				this->n_.clear();
+				this->actions_.clear();
+				this->child_begin_.clear();
+				this->child_size_.clear();
+				this->proofs_.clear();
+				this->addNode(-1);
 			}
+			this->actions_[0] = -1;
+			this->needs_recycle_ = false;
 		}
 
-		// m[hWJ
-		void expand() {
-			auto legal_actions = this->state_.legalActions();
-			this->child_nodes.clear();
-			for (const auto action : legal_actions) {
-				this->child_nodes.emplace_back(this->state_);
-				this->child_nodes.back().state_.advance(action);
+		// qm[h̏ؖς݂̒lm[h̒lminimaxŋ߂
+		// ؖ̕ꂽq1ł΁Aؖ̎qOɂĂƂ
+		Proof proveFromChildren(const int node) const {
+			const int begin = this->child_begin_[node];
+			const int end = begin + this->child_size_[node];
+			bool has_unproven = false;
+			bool has_draw = false;
+			for (int i = begin; i < end; i++) {
+				switch (this->proofs_[i]) {
+				case PROVEN_LOSS:
+					return PROVEN_WIN;
+				case UNPROVEN:
+					has_unproven = true;
+					break;
+				case PROVEN_DRAW:
+					has_draw = true;
+					break;
+				default:
+					break;
+				}
 			}
+			if (has_unproven)
+				return UNPROVEN;
+			return has_draw ? PROVEN_DRAW : PROVEN_LOSS;
 		}
 
 		// ǂ̃m[h]邩I
-		Node& nextChiledNode() {
-			for (auto& child_node : this->child_nodes) {
-				if (child_node.n_ == 0)
-					return child_node;
+		int nextChiledNode(const int node) const {
+			const int begin = this->child_begin_[node];
+			const int end = begin + this->child_size_[node];
+			for (int i = begin; i < end; i++) {
+				if (this->n_[i] == 0)
+					return i;
 			}
 			double t = 0;
-			for (const auto& child_node : this->child_nodes) {
-				t += child_node.n_;
+			for (int i = begin; i < end; i++) {
+				t += this->n_[i];
 			}
+			const double log_t = std::log(t);
 			double best_value = -INF;
 			int best_i = -1;
-			for (int i = 0; i < this->child_nodes.size(); i++) {
-				const auto& child_node = this->child_nodes[i];
-				double wr = 1. - child_node.w_ / child_node.n_;
-				double bias = std::sqrt(2. * std::log(t) / child_node.n_);
-
-				double ucb1_value = 1. - child_node.w_ / child_node.n_ + (double)C * std::sqrt(2. * std::log(t) / child_node.n_);
+			for (int i = begin; i < end; i++) {
+				if (this->proofs_[i] != UNPROVEN)
+					continue; // ̂؂͂ȏTȂ
+				const double ucb1_value = 1. - this->w_[i] / this->n_[i] + (double)C * std::sqrt(2. * log_t / this->n_[i]);
 				if (ucb1_value > best_value) {
 					best_i = i;
 					best_value = ucb1_value;
 				}
 			}
-			return this->child_nodes[best_i];
+			return best_i;
 		}
 
-		Node(const State& state) :state_(state), w_(0), n_(0) {}
+		// [g̃Q[_lؖς݂肷
+		bool isSolved()const {
+			return this->proofs_[0] != UNPROVEN;
+		}
 
+		// [g1]s
+		double evaluate() {
+			if (this->isSolved())
+				return 0;
+			if (this->needs_recycle_)
+				this->recycle();
+			State state = this->root_state_;
+			int node = 0;
+			this->path_.clear();
+			this->path_.emplace_back(node);
+			while (this->child_size_[node] > 0 && !state.isDone()) {
+				node = this->nextChiledNode(node);
+				state.advance(this->actions_[node]);
+				this->path_.emplace_back(node);
+			}
+
+			const double count = this->leaf_playout_number_;
+			double value;
+			if (state.isDone()) {
+				value = (state.isLose() ? 0 : 0.5) * count;
+				this->proofs_[node] = state.isLose() ? PROVEN_LOSS : PROVEN_DRAW;
+			}
+			else {
+				if (this->n_[node] + count >= EXPAND_THRESHOLD)
+					this->expand(node, state);
+				if (this->leaf_playout_number_ == 1)
+					value = playout(&state, this->rng_);
+				else
+					value = playoutBatch(state, this->leaf_playout_number_, this->rng_);
+			}
+
+			// t珇ɁAem[h̎Ԃ̃vC[_̒lZ
+			for (int k = (int)this->path_.size() - 1; k >= 0; k--) {
+				const int i = this->path_[k];
+				this->w_[i] += value;
+				this->n_[i] += count;
+				value = count - value;
+			}
+
+			// tŏؖꂽlAlςȂȂ܂Őe֓`
+			for (int k = (int)this->path_.size() - 2; k >= 0; k--) {
+				const int i = this->path_[k];
+				if (this->proofs_[this->path_[k + 1]] == UNPROVEN)
+					break;
+				this->proofs_[i] = this->proveFromChildren(i);
+			}
+			return (count - value) / count;
+		}
+
+		// [g̎qm[ĥłs񐔂̑sԂ
+		// ؖꂽs΂IсAؖꂽs͑Ɍ₪ȂΑI
+		Action bestAction() const {
+			const int begin = this->child_begin_[0];
+			const int end = begin + this->child_size_[0];
+			double best_n = -1;
+			int best_i = -1;
+			bool best_is_lost = true;
+			for (int i = begin; i < end; i++) {
+				if (this->proofs_[i] == PROVEN_LOSS)
+					return this->actions_[i];
+				const bool is_lost = this->proofs_[i] == PROVEN_WIN;
+				if ((best_is_lost && !is_lost) || (best_is_lost == is_lost && this->n_[i] > best_n)) {
+					best_i = i;
+					best_n = this->n_[i];
+					best_is_lost = is_lost;
+				}
+			}
+			return this->actions_[best_i];
+		}
 	};
 
 	// vCAEgw肵MCTSōs肷
 	Action mctsAction(const State& state, const int playout_number) {
-		Node root_node = Node(state);
-		root_node.expand();
+		Tree tree = Tree(state, mt());
+		tree.expandRoot();
 		for (int i = 0; i < playout_number; i++) {
-			root_node.evaluate();
+			if (tree.isSolved())
+				break;
+			tree.evaluate();
 		}
-		auto legal_actions = state.legalActions();
+		return tree.bestAction();
+	}
 
-		int best_n = -1;
-		int best_i = -1;
-		assert(legal_actions.size() == root_node.child_nodes.size());
-		for (int i = 0; i < legal_actions.size(); i++) {
-			int n = root_node.child_nodes[i].n_;
-			if (n > best_n) {
-				best_i = i;
-				best_n = n;
+	constexpr const int PROGRESS_INTERVAL = 256; // ro߂XVvCAEg̊Ԋu
+
+	// time_keeper~߂܂MCTSŒTA񐔂Ƃ̍őPprogressɏ
+	// budgetŒT؂̑傫𐧌łAstatisticsnƒTĨgpʂ
+	Action mctsActionWithTimeKeeper(const State& state, const TimeKeeper& time_keeper, SearchProgress* progress = nullptr, const NodeBudget& budget = NodeBudget(), TreeStatistics* statistics = nullptr) {
+		Tree tree = Tree(state, mt());
+		tree.setNodeBudget(budget);
+		tree.expandRoot();
+		for (int cnt = 0;; cnt++) {
+			if (time_keeper.isTimeOver() || tree.isSolved()) {
+				break;
 			}
+			tree.evaluate();
+			if (progress != nullptr && cnt % PROGRESS_INTERVAL == 0)
+				progress->update(tree.bestAction(), cnt + 1);
 		}
-		return legal_actions[best_i];
+		if (statistics != nullptr)
+			*statistics = tree.statistics();
+		return tree.bestAction();
 	}
 
 	// (ms)w肵MCTSōs肷
-	Action mctsActionWithTimeThreshold(const State& state, const int64_t time_threshold) {
-		Node root_node = Node(state);
-		root_node.expand();
+	Action mctsActionWithTimeThreshold(const State& state, const int64_t time_threshold, const NodeBudget& budget = NodeBudget(), TreeStatistics* statistics = nullptr) {
 		auto time_keeper = TimeKeeper(time_threshold);
-		for (int cnt = 0;; cnt++) {
-			if (time_keeper.isTimeOver()) {
-				break;
+		return mctsActionWithTimeKeeper(state, time_keeper, nullptr, budget, statistics);
+	}
+
+	// Ԃ܂ŒT؂ėpMCTS
+	// ǂ݂LɂƁAsԂ̎Ԃ̋ǖʂʃXbhŒT
+	// playGametestFirstPlayerWinRate͗AI𓯂vZXŏɌĂԂ̂ŁAǂ݂̃Xbh͑̒TCPU荇
+	// ̂ߑΐ̏͐ǂ݂̌ʂ𐳂\ȂBǂ݂͎ۂ̑΋ǂŎgA̔rł͐؂Ă
+	class MctsSearcher {
+	private:
+		std::unique_ptr<Tree> tree_;
+		int symmetry_; // T؂̔Ֆʂۂ̔ՖʂɈڂΏ̕ϊBT؂̍s͕ԂOɂňڂ
+		Xoshiro128 rng_;
+		int leaf_playout_number_;
+		NodeBudget budget_;
+		bool is_pondering_; // ̎Ԓɐǂ݂邩
+		std::thread ponder_thread_;
+		std::atomic<bool> stop_pondering_;
+
+		// ~߂܂Ō݂̒T؂T
+		void ponder() {
+			while (!this->stop_pondering_ && !this->tree_->isSolved()) {
+				this->tree_->evaluate();
 			}
-			root_node.evaluate();
 		}
-		auto legal_actions = state.legalActions();
 
-		int best_n = -1;
-		int best_i = -1;
-		assert(legal_actions.size() == root_node.child_nodes.size());
-		for (int i = 0; i < legal_actions.size(); i++) {
-			int n = root_node.child_nodes[i].n_;
-			if (n > best_n) {
-				best_i = i;
-				best_n = n;
+		// ̎Ԃ̋ǖʂŐǂ݂n߂
+		void startPondering() {
+			if (!this->is_pondering_ || this->tree_->rootState().isDone())
+				return;
+			this->tree_->expandRoot();
+			this->stop_pondering_ = false;
+			this->ponder_thread_ = std::thread(&MctsSearcher::ponder, this);
+		}
+
+		// ǂ݂~߁AXbh̏I҂
+		void stopPondering() {
+			if (this->ponder_thread_.joinable()) {
+				this->stop_pondering_ = true;
+				this->ponder_thread_.join();
 			}
 		}
-		return legal_actions[best_i];
-	}
+
+		// O̒T؂stateɈv镔؂Tă[gɂBȂ΍蒼
+		// T؂̎qm[h͑Ώ̂ȍs1ɂ܂Ƃ߂Ă̂ŁAstateɑΏ̕ϊňڂqm[hT
+		void syncRoot(const State& state) {
+			if (this->tree_) {
+				const auto& tree = *this->tree_;
+				int symmetry = tree.rootState().symmetryTo(state);
+				if (symmetry < 0) {
+					const int begin = tree.child_begin_[0];
+					const int end = begin + tree.child_size_[0];
+					Action matched_action = -1;
+					for (int i = begin; i < end && matched_action < 0; i++) {
+						State next_state = tree.rootState();
+						next_state.advance(tree.actions_[i]);
+						symmetry = next_state.symmetryTo(state);
+						if (symmetry >= 0)
+							matched_action = tree.actions_[i];
+					}
+					if (matched_action >= 0)
+						this->tree_->advanceRoot(matched_action);
+					else
+						this->tree_.reset();
+				}
+				this->symmetry_ = symmetry;
+			}
+			if (!this->tree_) {
+				this->tree_ = std::make_unique<Tree>(state, this->rng_(), this->leaf_playout_number_);
+				this->tree_->setNodeBudget(this->budget_);
+				this->symmetry_ = 0;
+			}
+			this->tree_->expandRoot();
+		}
+
+	public:
+		MctsSearcher(const uint64_t seed = mt(), const int leaf_playout_number = 1) :
+			symmetry_(0),
+			rng_(seed),
+			leaf_playout_number_(leaf_playout_number),
+			is_pondering_(false),
+			stop_pondering_(false)
+		{}
+
+		~MctsSearcher() {
+			this->stopPondering();
+		}
+
+		// ̎Ԓɐǂ݂邩ݒ肷BƓvZXœƑ̒Tx
+		void setPondering(const bool is_pondering) {
+			this->is_pondering_ = is_pondering;
+		}
+
+		// Ԃ܂ŎT؂̑傫̏ݒ肷
+		// ėp̒T؂ɂɓKp̂ŁA蒼܂ŏ𒴂ĈƂ͂Ȃ
+		void setNodeBudget(const NodeBudget& budget) {
+			const bool was_pondering = this->ponder_thread_.joinable();
+			this->stopPondering();
+			this->budget_ = budget;
+			if (this->tree_)
+				this->tree_->setNodeBudget(budget);
+			if (was_pondering)
+				this->startPondering();
+		}
+
+		// T؂̃gpʂԂBǂݒ͐ǂ݂~߂ĂԂ
+		TreeStatistics statistics() {
+			this->stopPondering();
+			return this->tree_ ? this->tree_->statistics() : TreeStatistics();
+		}
+
+		// (ms)w肵MCTSōs肵AT؂肵s̐ɐi߂Ă
+		// ǂ݂Ăꍇ́Aۂ̑̍sɈv镔؂̓v̂܂܈p
+		Action actionWithTimeThreshold(const State& state, const int64_t time_threshold) {
+			this->stopPondering();
+			this->syncRoot(state);
+			auto time_keeper = TimeKeeper(time_threshold);
+			while (!time_keeper.isTimeOver() && !this->tree_->isSolved()) {
+				this->tree_->evaluate();
+			}
+			const Action action = this->tree_->bestAction();
+			this->tree_->advanceRoot(action);
+			this->startPondering();
+			return State::transformAction(action, this->symmetry_);
+		}
+
+		// ݂̃[gł̎s񐔂ԂBǂݒ͐ǂ݂~߂ĂԂ
+		double rootVisitCount() {
+			this->stopPondering();
+			return this->tree_ ? this->tree_->n_[0] : 0;
+		}
+	};
 }
 using montecarlo::primitiveMontecarloAction;
 using montecarlo::mctsAction;
 using montecarlo::mctsActionWithTimeThreshold;
 using montecarlo::primitiveMontecarloActionWithTimeThreshold;
+using montecarlo::MctsSearcher;
+using montecarlo::mctsActionWithTimeKeeper;
+using montecarlo::NodeBudget;
+using montecarlo::TreeStatistics;
+
+// ʃXbhŒTi߁Aro߂̎擾AԐ̕ύXAfłnh
+// Ăяo̓ubNisFinishedbestActionŏ󋵂mFł
+class SearchHandle {
+private:
+	TimeKeeper time_keeper_;
+	SearchProgress progress_;
+	std::atomic<bool> is_finished_;
+	std::thread thread_;
+
+public:
+	using SearchFunction = std::function<Action(const TimeKeeper&, SearchProgress*)>;
+
+	// T֐ƎԐ(ms)w肵ĒTJn
+	SearchHandle(const SearchFunction& search, const int64_t time_threshold) :
+		time_keeper_(time_threshold),
+		is_finished_(false)
+	{
+		this->thread_ = std::thread([this, search]() {
+			const Action action = search(this->time_keeper_, &this->progress_);
+			if (action >= 0)
+				this->progress_.best_action_ = action;
+			this->is_finished_ = true;
+			});
+	}
+
+	~SearchHandle() {
+		this->cancel();
+		if (this->thread_.joinable())
+			this->thread_.join();
+	}
+
+	// TI肷
+	bool isFinished()const {
+		return this->is_finished_;
+	}
+
+	// _̍őPԂB܂Ȃ-1
+	Action bestAction()const {
+		return this->progress_.best_action_;
+	}
+
+	// ̐Ԃ
+	int64_t iteration()const {
+		return this->progress_.iteration_;
+	}
+
+	// TJn̎Ԑ(ms)ύX
+	void setTimeThreshold(const int64_t time_threshold) {
+		this->time_keeper_.setTimeThreshold(time_threshold);
+	}
+
+	// T𒆒f
+	void cancel() {
+		this->time_keeper_.cancel();
+	}
+
+	// T̏I҂čőPԂ
+	Action wait() {
+		if (this->thread_.joinable())
+			this->thread_.join();
+		return this->bestAction();
+	}
+};
+
+// Ԑ(ms)w肵Ĕ[̔񓯊TJn
+std::unique_ptr<SearchHandle> startIterativeDeepningSearch(const State& state, const int64_t time_threshold) {
+	return std::make_unique<SearchHandle>([state](const TimeKeeper& time_keeper, SearchProgress* progress) {
+		return iterativeDeepningActionWithTimeKeeper(state, time_keeper, progress);
+		}, time_threshold);
+}
+
+// Ԑ(ms)w肵MCTS̔񓯊TJn
+std::unique_ptr<SearchHandle> startMctsSearch(const State& state, const int64_t time_threshold) {
+	return std::make_unique<SearchHandle>([state](const TimeKeeper& time_keeper, SearchProgress* progress) {
+		return mctsActionWithTimeKeeper(state, time_keeper, progress);
+		}, time_threshold);
+}
+
+
+// ȑΐŊwKf[^
+// t@C̓wb_̌Ƀ`NǋLĂ`ŁA`N͋ǖʂƂ̋L^l߂
+// `N͏IĂ܂Ƃ߂ĒǋL̂ŁArŎ~܂Ẵ`Nǂݔ΂ΉȂ
+namespace selfplay {
+	constexpr const char FILE_MAGIC[8] = "SPDATA1"; // t@C`̎ʎq
+	constexpr const uint32_t CHUNK_MAGIC = 0x4b4e4843; // "CHNK"
+	constexpr const size_t CHUNK_BYTE_SIZE = 1 << 20; // `Nt@Cɏo傫̖ڈ
+
+	// t@C̐擪ɒuwb_
+	struct FileHeader {
+		char magic[8];
+		uint32_t game_id; // ǂ̃Q[̃f[^
+		uint32_t reserved;
+	};
+
+	// `N̐擪ɒuwb_
+	struct ChunkHeader {
+		uint32_t magic;
+		uint32_t record_number;
+		uint64_t byte_size; // ̃wb_`N̑傫
+	};
+
+	// 1ǖʕ̋L^̐擪ɒuwb_
+	// ɍs(int32_t)A(float)AՖ(oCgA4oCgE܂ŋlߕ)
+	struct RecordHeader {
+		uint32_t game_index; // ǖڂ
+		uint32_t state_size; // Ֆʂ̃oCg
+		uint16_t ply; // ڂ
+		uint16_t policy_size; // ̗vf
+		uint8_t action_number; // L^s̐
+		uint8_t reserved[3];
+		float outcome; // ŏI
+	};
+
+	// L^1̃oCgԂ
+	size_t recordByteSize(const RecordHeader& header) {
+		return sizeof(RecordHeader) + header.action_number * sizeof(int32_t) + header.policy_size * sizeof(float) + (header.state_size + 3) / 4 * 4;
+	}
+
+	// ̃Xbh`NPʂŒǋLt@C
+	class Writer {
+	private:
+		std::ofstream ofs_;
+		std::mutex mutex_;
+
+	public:
+		// t@CǋLpɊJAȂwb_
+		Writer(const std::string& path, const uint32_t game_id) :ofs_(path, std::ios::binary | std::ios::app) {
+			if (!this->ofs_)throw std::string("cannot open ") + path;
+			this->ofs_.seekp(0, std::ios::end);
+			if (this->ofs_.tellp() == 0) {
+				FileHeader header{};
+				std::memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+				header.game_id = game_id;
+				this->ofs_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				this->ofs_.flush();
+			}
+		}
+
+		// L^l߂oCg1̃`NƂĒǋL
+		void appendChunk(const std::vector<uint8_t>& records, const uint32_t record_number) {
+			ChunkHeader header{ CHUNK_MAGIC, record_number, records.size() };
+			std::lock_guard<std::mutex> lock(this->mutex_);
+			this->ofs_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			this->ofs_.write(reinterpret_cast<const char*>(records.data()), records.size());
+			this->ofs_.flush();
+		}
+	};
+
+	// XbhƂɋL^𗭂߁Ȃ傫ɂȂWriterɃ`NƂēn
+	class ChunkBuffer {
+	private:
+		Writer* writer_;
+		std::vector<uint8_t> bytes_;
+		uint32_t record_number_;
+
+	public:
+		explicit ChunkBuffer(Writer* writer) :writer_(writer), record_number_(0) {
+			this->bytes_.reserve(CHUNK_BYTE_SIZE * 2);
+		}
+
+		~ChunkBuffer() {
+			this->flush();
+		}
+
+		// 1ǖʕ̋L^ǉ
+		void addRecord(const RecordHeader& header, const int32_t* actions, const float* policy, const uint8_t* state) {
+			const size_t offset = this->bytes_.size();
+			this->bytes_.resize(offset + recordByteSize(header));
+			uint8_t* p = this->bytes_.data() + offset;
+			std::memcpy(p, &header, sizeof(header));
+			p += sizeof(header);
+			std::memcpy(p, actions, header.action_number * sizeof(int32_t));
+			p += header.action_number * sizeof(int32_t);
+			std::memcpy(p, policy, header.policy_size * sizeof(float));
+			p += header.policy_size * sizeof(float);
+			std::memcpy(p, state, header.state_size);
+			this->record_number_++;
+			if (this->bytes_.size() >= CHUNK_BYTE_SIZE)this->flush();
+		}
+
+		// ܂ĂL^o
+		void flush() {
+			if (this->record_number_ == 0)return;
+			this->writer_->appendChunk(this->bytes_, this->record_number_);
+			this->bytes_.clear();
+			this->record_number_ = 0;
+		}
+	};
+
+	// L^1At@C̃f[^w܂ܓǂނ߂̃r[
+	struct Record {
+		RecordHeader header;
+		const int32_t* actions;
+		const float* policy;
+		const uint8_t* state;
+	};
+
+	// wKf[^̃t@C}bvēǂށB}bvłȂł̓t@CŜǂݍ
+	class Reader {
+	private:
+		const uint8_t* data_;
+		size_t size_;
+		void* mapped_;
+		std::vector<uint8_t> buffer_;
+		FileHeader header_;
+
+	public:
+		// RXgN^O𓊂ƃfXgN^͌Ă΂Ȃ̂ŁA؂I܂łmmap̈[JϐŎ
+		explicit Reader(const std::string& path) :data_(nullptr), size_(0), mapped_(nullptr) {
+			void* mapped = nullptr;
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+#ifndef _WIN32
+			const int fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0)throw std::string("cannot open ") + path;
+			struct stat st;
+			if (fstat(fd, &st) == 0 && st.st_size > 0) {
+				void* result = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+				if (result != MAP_FAILED) {
+					mapped = result;
+					data = static_cast<const uint8_t*>(result);
+					size = st.st_size;
+				}
+			}
+			close(fd);
+#endif
+			if (data == nullptr) {
+				std::ifstream ifs(path, std::ios::binary);
+				if (!ifs)throw std::string("cannot open ") + path;
+				this->buffer_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+				data = this->buffer_.data();
+				size = this->buffer_.size();
+			}
+			// ꂽt@CȂAmmap̈ĂO𓊂
+			const auto broken = [&]() {
+#ifndef _WIN32
+				if (mapped != nullptr)
+					munmap(mapped, size);
+#endif
+				return std::string("broken self-play data ") + path;
+			};
+			if (size < sizeof(FileHeader))throw broken();
+			std::memcpy(&this->header_, data, sizeof(FileHeader));
+			if (std::memcmp(this->header_.magic, FILE_MAGIC, sizeof(this->header_.magic)) != 0)
+				throw broken();
+			this->mapped_ = mapped;
+			this->data_ = data;
+			this->size_ = size;
+		}
+
+		Reader(const Reader&) = delete;
+		Reader& operator=(const Reader&) = delete;
+
+		~Reader() {
+#ifndef _WIN32
+			if (this->mapped_ != nullptr)
+				munmap(this->mapped_, this->size_);
+#endif
+		}
+
+		// ǂ̃Q[̃f[^Ԃ
+		uint32_t gameId()const {
+			return this->header_.game_id;
+		}
+
+		// SĂ̋L^擪珇callbackɓnAL^̐ԂB̃`N͓ǂ܂Ȃ
+		int64_t forEachRecord(const std::function<void(const Record&)>& callback)const {
+			int64_t record_number = 0;
+			size_t offset = sizeof(FileHeader);
+			while (offset + sizeof(ChunkHeader) <= this->size_) {
+				ChunkHeader chunk;
+				std::memcpy(&chunk, this->data_ + offset, sizeof(chunk));
+				offset += sizeof(chunk);
+				if (chunk.magic != CHUNK_MAGIC || offset + chunk.byte_size > this->size_)break;
+				const uint8_t* p = this->data_ + offset;
+				for (uint32_t i = 0; i < chunk.record_number; i++) {
+					Record record;
+					std::memcpy(&record.header, p, sizeof(record.header));
+					record.actions = reinterpret_cast<const int32_t*>(p + sizeof(RecordHeader));
+					record.policy = reinterpret_cast<const float*>(record.actions + record.header.action_number);
+					record.state = reinterpret_cast<const uint8_t*>(record.policy + record.header.policy_size);
+					callback(record);
+					p += recordByteSize(record.header);
+					record_number++;
+				}
+				offset += chunk.byte_size;
+			}
+			return record_number;
+		}
+	};
+
+	constexpr const uint32_t GAME_ID = 1; // ݓlQ[̃f[^
+	constexpr const int SAMPLING_PLY_NUMBER = 2; // Ղ̑l̂߁A̎萔܂łMCTS̎s񐔂ɔႵmōsI
+
+	// 1ǂȑΐ킵AǖʂƂ̔ՖʁAI񂾍sAMCTS̎s񐔂̕zAԑ猩ŏIʂL^
+	void playSelfPlayGame(const uint32_t game_index, const int playout_number, Xoshiro128& rng, ChunkBuffer* buffer) {
+		struct Position {
+			State state;
+			int32_t action;
+			float policy[State::MAX_ACTION_NUMBER];
+		};
+		std::vector<Position> positions;
+		auto state = State();
+		while (!state.isDone()) {
+			Position position{ state, -1, {} };
+			montecarlo::Tree tree = montecarlo::Tree(state, rng());
+			tree.expandRoot();
+			for (int i = 0; i < playout_number && !tree.isSolved(); i++) {
+				tree.evaluate();
+			}
+			const int begin = tree.child_begin_[0];
+			const int end = begin + tree.child_size_[0];
+			double total = 0;
+			for (int i = begin; i < end; i++) {
+				total += tree.n_[i];
+			}
+			for (int i = begin; i < end; i++) {
+				position.policy[tree.actions_[i]] = total > 0 ? (float)(tree.n_[i] / total) : 0.f;
+			}
+			Action action = tree.bestAction();
+			if ((int)positions.size() < SAMPLING_PLY_NUMBER && total > 0) {
+				double r = rng() / 4294967296. * total;
+				for (int i = begin; i < end; i++) {
+					r -= tree.n_[i];
+					if (r < 0) {
+						action = tree.actions_[i];
+						break;
+					}
+				}
+			}
+			position.action = action;
+			positions.emplace_back(position);
+			state.advance(action);
+		}
+		const double first_player_score = state.getFirstPlayerScoreForWinRate();
+		std::vector<uint8_t> encoded;
+		for (int ply = 0; ply < (int)positions.size(); ply++) {
+			const auto& position = positions[ply];
+			encoded.resize(position.state.encodedSize());
+			position.state.encode(encoded.data());
+			RecordHeader header{};
+			header.game_index = game_index;
+			header.state_size = (uint32_t)encoded.size();
+			header.ply = (uint16_t)ply;
+			header.policy_size = State::MAX_ACTION_NUMBER;
+			header.action_number = 1;
+			header.outcome = (float)(ply % 2 == 0 ? first_player_score : 1 - first_player_score);
+			buffer->addRecord(header, &position.action, position.policy, encoded.data());
+		}
+	}
+
+	// Xbh1̎ȑΐBSXbhŋLԍȂgame_numberǂ܂őΐ킷
+	void selfPlayWorker(Writer* writer, std::atomic<uint32_t>* next_game_index, const uint32_t game_number, const int playout_number, const uint64_t seed) {
+		Xoshiro128 rng(seed);
+		ChunkBuffer buffer(writer);
+		for (uint32_t game_index = (*next_game_index)++; game_index < game_number; game_index = (*next_game_index)++) {
+			playSelfPlayGame(game_index, playout_number, rng, &buffer);
+		}
+	}
+
+	// 1肠̃vCAEgƃXbhw肵game_numberǂȑΐ킵AwKf[^path̃t@CɒǋL
+	void runSelfPlay(const std::string& path, const uint32_t game_number, const int playout_number, const int thread_number) {
+		Writer writer(path, GAME_ID);
+		std::atomic<uint32_t> next_game_index(0);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < thread_number; t++) {
+			threads.emplace_back(selfPlayWorker, &writer, &next_game_index, game_number, playout_number, (uint64_t)mt());
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+}
+using selfplay::runSelfPlay;
+
+#ifndef _WIN32
+// ̃vZXő΋ǂ𕪒S
+// R[fBl[^[UnixhC\Pbgő҂󂯁AڑĂ[J[1ǂdnČʂ󂯎
+// ʂ1ǂƂɒǋL̂ŁAR[fBl[^[⃏[J[~܂ĂI΋ǂ͎Ȃ
+// ḾuREADYvuGAME  ݒ V[hvuRESULT  ʁvuDONEv1s̃eLXgōs
+namespace farm {
+	constexpr const int POLL_INTERVAL = 100; // ҂󂯂̊Ԋu(ms)
+	constexpr const int CONNECT_RETRY_NUMBER = 100; // [J[R[fBl[^[̋N҂
+
+	// 1Ǖ̎dBconfigurationԖڂ̐ݒŁAseedՖʂ1ǃvC
+	struct Task {
+		int game_index;
+		int configuration;
+		uint32_t seed;
+	};
+
+	// game_indexǖڂ̎dԂBSĂ̐ݒ肪V[hɃvC悤U
+	Task taskOf(const int game_index, const int configuration_number) {
+		return Task{ game_index, game_index % configuration_number, (uint32_t)(game_index / configuration_number) };
+	}
+
+	// 1sBȂfalseԂ
+	bool sendLine(const int fd, const std::string& line) {
+		const std::string data = line + "\n";
+		size_t sent = 0;
+		while (sent < data.size()) {
+			const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+			if (n < 0 && errno == EINTR)
+				continue;
+			if (n <= 0)
+				return false;
+			sent += n;
+		}
+		return true;
+	}
+
+	// Mf[^bufferɒǋLBؒfꂽfalseԂ
+	bool receive(const int fd, std::string* buffer) {
+		char data[4096];
+		const ssize_t n = recv(fd, data, sizeof(data), 0);
+		if (n < 0 && errno == EINTR)
+			return true;
+		if (n <= 0)
+			return false;
+		buffer->append(data, n);
+		return true;
+	}
+
+	// buffer1soB܂1sĂȂfalseԂ
+	bool popLine(std::string* buffer, std::string* line) {
+		const size_t position = buffer->find('\n');
+		if (position == std::string::npos)
+			return false;
+		*line = buffer->substr(0, position);
+		buffer->erase(0, position + 1);
+		return true;
+	}
+
+	// pathUnixhC\Pbg̃AhXԂ
+	sockaddr_un socketAddress(const std::string& path) {
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		if (path.size() >= sizeof(address.sun_path))
+			throw std::string("socket path too long ") + path;
+		std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+		return address;
+	}
+
+	// [J[ɎdzAʂt@CɒǋLR[fBl[^[
+	// ʃt@Ću ݒ V[h ʁv̍s̕тŁAʂ̐擪̓XRAɂ
+	// NɌʃt@Cǂ݁AIĂǂ͔zȂ
+	class Coordinator {
+	private:
+		struct Worker {
+			int fd;
+			std::string buffer;
+			bool is_waiting; // d҂Ă邩
+			int game_index; // S̋ǁBȂ-1
+		};
+
+		std::string socket_path_;
+		int listen_fd_;
+		int game_number_;
+		int configuration_number_;
+		std::ofstream result_stream_;
+		std::vector<uint8_t> is_done_;
+		int done_number_;
+		std::deque<int> pending_; // ܂NɂnĂȂ
+		std::vector<Worker> workers_;
+		std::vector<double> score_sums_; // ݒ育Ƃ̃XRA̘a
+		std::vector<int> score_counts_; // ݒ育Ƃ̏Iǐ
+
+		// ʂ1sǂݍŏWvAWvłԂBꂽsdǂ͖
+		bool load(const std::string& line) {
+			std::istringstream iss(line);
+			int game_index, configuration;
+			uint32_t seed;
+			double score;
+			if (!(iss >> game_index >> configuration >> seed >> score))
+				return false;
+			if (game_index < 0 || game_index >= this->game_number_ || this->is_done_[game_index])
+				return false;
+			const Task task = taskOf(game_index, this->configuration_number_);
+			if (task.configuration != configuration || task.seed != seed)
+				return false;
+			this->is_done_[game_index] = 1;
+			++this->done_number_;
+			this->score_sums_[configuration] += score;
+			++this->score_counts_[configuration];
+			return true;
+		}
+
+		// ҂Ă郏[J[Ɏ̋ǂnBSďIĂΏI`
+		bool assign(Worker* worker) {
+			if (this->pending_.empty()) {
+				if (!this->isFinished())
+					return true; // ̃[J[S̋ǂ߂Ă邩Ȃ̂ő҂
+				worker->is_waiting = false;
+				return sendLine(worker->fd, "DONE");
+			}
+			const Task task = taskOf(this->pending_.front(), this->configuration_number_);
+			this->pending_.pop_front();
+			worker->is_waiting = false;
+			worker->game_index = task.game_index;
+			return sendLine(worker->fd, "GAME " + std::to_string(task.game_index) + " " + std::to_string(task.configuration) + " " + std::to_string(task.seed));
+		}
+
+		// [J[󂯎1sBڑ؂ׂȂfalseԂ
+		bool handle(Worker* worker, const std::string& line) {
+			std::istringstream iss(line);
+			std::string command;
+			iss >> command;
+			if (command == "READY") {
+				worker->is_waiting = true;
+				return this->assign(worker);
+			}
+			if (command != "RESULT")
+				return false;
+			int game_index;
+			if (!(iss >> game_index) || game_index < 0 || game_index >= this->game_number_)
+				return false;
+			if (game_index == worker->game_index) {
+				worker->game_index = -1;
+				worker->is_waiting = true;
+			}
+			else if (!this->is_done_[game_index])
+				return false; // nĂȂǂ̌
+			// z蒼ǂ𑼂̃[J[ɏIĂꍇ́Aʂ̂ĂĐڑ͂̂܂܎g
+			if (!this->is_done_[game_index]) {
+				std::string result;
+				std::getline(iss >> std::ws, result);
+				const Task task = taskOf(game_index, this->configuration_number_);
+				const std::string record = std::to_string(task.game_index) + " " + std::to_string(task.configuration) + " " + std::to_string(task.seed) + " " + result;
+				if (!this->load(record))
+					return false;
+				this->result_stream_ << record << std::endl;
+			}
+			return worker->is_waiting ? this->assign(worker) : true;
+		}
+
+		// ҂sɂڑSĎ󂯕t
+		void acceptAll() {
+			int fd;
+			while ((fd = accept(this->listen_fd_, nullptr, nullptr)) >= 0) {
+				this->workers_.emplace_back(Worker{ fd, "", false, -1 });
+			}
+		}
+
+		// ڑAS̋ǂΔz蒼
+		void drop(Worker* worker) {
+			close(worker->fd);
+			worker->fd = -1;
+			if (worker->game_index >= 0 && !this->is_done_[worker->game_index])
+				this->pending_.push_front(worker->game_index);
+		}
+
+	public:
+		Coordinator(const std::string& socket_path, const std::string& result_path, const int game_number, const int configuration_number) :
+			socket_path_(socket_path),
+			listen_fd_(-1),
+			game_number_(game_number),
+			configuration_number_(configuration_number),
+			is_done_(game_number, 0),
+			done_number_(0),
+			score_sums_(configuration_number, 0),
+			score_counts_(configuration_number, 0)
+		{
+			bool ends_with_newline = true;
+			off_t complete_size = 0; // sŏIĂs܂ł̃oCg
+			{
+				std::ifstream ifs(result_path);
+				std::string line;
+				while (std::getline(ifs, line)) {
+					if (ifs.eof()) {
+						ends_with_newline = false;
+						break;
+					}
+					this->load(line);
+					complete_size += line.size() + 1;
+				}
+			}
+			if (!ends_with_newline && truncate(result_path.c_str(), complete_size) != 0) // Ŏ~܂Ō̍ŝ͎Ă
+				throw std::string("cannot truncate ") + result_path;
+			this->result_stream_.open(result_path, std::ios::app);
+			if (!this->result_stream_)
+				throw std::string("cannot open ") + result_path;
+			for (int game_index = 0; game_index < game_number; game_index++) {
+				if (!this->is_done_[game_index])
+					this->pending_.emplace_back(game_index);
+			}
+
+			const auto address = socketAddress(socket_path);
+			unlink(socket_path.c_str());
+			this->listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (this->listen_fd_ < 0
+				|| bind(this->listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+				|| listen(this->listen_fd_, SOMAXCONN) != 0
+				|| fcntl(this->listen_fd_, F_SETFL, O_NONBLOCK) != 0) // ڑėĂ1̑҂󂯂ł܂Ƃ߂Ď󂯕t悤ɂ
+				throw std::string("cannot listen on ") + socket_path;
+		}
+
+		Coordinator(const Coordinator&) = delete;
+		Coordinator& operator=(const Coordinator&) = delete;
+
+		~Coordinator() {
+			this->shutdown();
+		}
+
+		// SĂ̋ǂI肷
+		bool isFinished()const {
+			return this->done_number_ == this->game_number_;
+		}
+
+		// IǐԂ
+		int doneNumber()const {
+			return this->done_number_;
+		}
+
+		// őtimeout(ms)҂āAڑ̎󂯕tƌʂ̎󂯎
+		void step(const int timeout) {
+			std::vector<pollfd> fds = { pollfd{ this->listen_fd_, POLLIN, 0 } };
+			for (const auto& worker : this->workers_) {
+				fds.emplace_back(pollfd{ worker.fd, POLLIN, 0 });
+			}
+			if (poll(fds.data(), fds.size(), timeout) < 0)
+				return;
+			for (int i = 0; i < (int)this->workers_.size(); i++) {
+				auto& worker = this->workers_[i];
+				if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)))
+					continue;
+				bool is_alive = receive(worker.fd, &worker.buffer);
+				std::string line;
+				while (is_alive && popLine(&worker.buffer, &line)) {
+					is_alive = this->handle(&worker, line);
+				}
+				if (!is_alive)
+					this->drop(&worker);
+			}
+			this->workers_.erase(std::remove_if(this->workers_.begin(), this->workers_.end(), [](const Worker& worker) { return worker.fd < 0; }), this->workers_.end());
+			if (fds[0].revents & POLLIN)
+				this->acceptAll();
+			// z蒼ɂȂǂ҂Ă郏[J[ɓn
+			for (auto& worker : this->workers_) {
+				if (worker.is_waiting && !this->assign(&worker))
+					this->drop(&worker);
+			}
+			this->workers_.erase(std::remove_if(this->workers_.begin(), this->workers_.end(), [](const Worker& worker) { return worker.fd < 0; }), this->workers_.end());
+		}
+
+		// ҂󂯂߁AڑƐڑ҂̃[J[SĂɏI`ă\Pbg
+		// IɃ[J[̏I҂Ƃ́AɂĂő҂郏[J[cȂ悤ɂ
+		void shutdown() {
+			if (this->listen_fd_ < 0)
+				return;
+			this->acceptAll();
+			for (auto& worker : this->workers_) {
+				if (worker.fd >= 0)
+					sendLine(worker.fd, "DONE");
+			}
+			this->releaseSockets();
+			unlink(this->socket_path_.c_str());
+		}
+
+		// \PbgSĕBforkqvZXł͈p\Pbgŕ
+		void releaseSockets() {
+			for (auto& worker : this->workers_) {
+				if (worker.fd >= 0)
+					close(worker.fd);
+				worker.fd = -1;
+			}
+			this->workers_.clear();
+			if (this->listen_fd_ >= 0)
+				close(this->listen_fd_);
+			this->listen_fd_ = -1;
+		}
+
+		// ݒ育Ƃ̕σXRA𕶎ɂ
+		std::string summary()const {
+			std::stringstream ss;
+			for (int configuration = 0; configuration < this->configuration_number_; configuration++) {
+				const int count = this->score_counts_[configuration];
+				ss << "Score of configuration " << configuration << ":\t" << (count > 0 ? this->score_sums_[configuration] / count : 0.) << " (" << count << " games)\n";
+			}
+			return ss.str();
+		}
+	};
+
+	// R[fBl[^[ɐڑAnꂽdplay_gameŃvCČʂԂBI`邩ؒfꂽ߂
+	void runWorker(const std::string& socket_path, const std::function<std::string(const Task&)>& play_game) {
+		const auto address = socketAddress(socket_path);
+		int fd = -1;
+		for (int retry = 0;; retry++) {
+			fd = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0)
+				break;
+			if (fd >= 0)
+				close(fd);
+			if (retry >= CONNECT_RETRY_NUMBER)
+				throw std::string("cannot connect to ") + socket_path;
+			std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL));
+		}
+		std::string buffer, line;
+		if (sendLine(fd, "READY")) {
+			while (true) {
+				while (!popLine(&buffer, &line)) {
+					if (!receive(fd, &buffer)) {
+						close(fd);
+						return;
+					}
+				}
+				std::istringstream iss(line);
+				std::string command;
+				Task task;
+				iss >> command;
+				if (command != "GAME" || !(iss >> task.game_index >> task.configuration >> task.seed))
+					break;
+				if (!sendLine(fd, "RESULT " + std::to_string(task.game_index) + " " + play_game(task)))
+					break;
+			}
+		}
+		close(fd);
+	}
+}
+#endif
 
 
 #include<iostream>
@@ -512,7 +2521,8 @@ using AIFunction = std::function<Action(const State&)>;
 using StringAIPair = std::pair<std::string, AIFunction>;
 
 // Q[1vCăQ[󋵂\
-void playGame(const std::vector<StringAIPair>& ais) {
+// prints_boardfalseȂ疈^[̔Ֆʂ̕񉻂ȂAsƍŌ̔Ֆʂ\
+void playGame(const std::vector<StringAIPair>& ais, const bool prints_board = true) {
 	using std::cout; using std::endl;
 	auto state = State();
 	while (!state.isDone()) {
@@ -522,7 +2532,7 @@ void playGame(const std::vector<StringAIPair>& ais) {
 			Action action = ais[0].second(state);
 			cout << "action " << action << endl;
 			state.advance(action);
-			cout << state.toString() << endl;
+			if (prints_board)cout << state.toString() << endl;
 			if (state.isDone())break;
 		}
 		// 2p
@@ -531,10 +2541,250 @@ void playGame(const std::vector<StringAIPair>& ais) {
 			Action action = ais[1].second(state);
 			cout << "action " << action << endl;
 			state.advance(action);
-			cout << state.toString() << endl;
+			if (prints_board)cout << state.toString() << endl;
 			if (state.isDone())break;
 		}
 	}
+	if (!prints_board)cout << state.toString() << endl;
+}
+
+// BՖʂ̍s̗ƎvlԂAՖʂreplayō蒼
+struct GameRecord {
+	Actions actions;
+	std::vector<int64_t> microseconds; // sƂ̎vl(s)
+
+	// us s... vl...v1sŏo
+	void write(std::ostream& os)const {
+		os << this->actions.size();
+		for (const auto action : this->actions)os << ' ' << action;
+		for (const auto microsecond : this->microseconds)os << ' ' << microsecond;
+		os << '\n';
+	}
+
+	// writeŏ1sǂݍށBǂ߂ȂfalseԂ
+	bool read(std::istream& is) {
+		size_t action_number;
+		if (!(is >> action_number))return false;
+		this->actions.resize(action_number);
+		this->microseconds.resize(action_number);
+		for (auto& action : this->actions)is >> action;
+		for (auto& microsecond : this->microseconds)is >> microsecond;
+		return (bool)is;
+	}
+
+	// turnڂ܂Ői߂Ֆʂ蒼
+	State replay(const int turn)const {
+		auto state = State();
+		for (int i = 0; i < turn && i < (int)this->actions.size(); i++) {
+			state.advance(this->actions[i]);
+		}
+		return state;
+	}
+};
+
+// Q[1vCĊԂBՖʂ̕\͂Ȃ
+GameRecord recordGame(const std::vector<StringAIPair>& ais) {
+	GameRecord record;
+	auto state = State();
+	for (int turn = 0; !state.isDone(); turn++) {
+		const auto start_time = std::chrono::high_resolution_clock::now();
+		const Action action = ais[turn % 2].second(state);
+		const auto diff = std::chrono::high_resolution_clock::now() - start_time;
+		record.actions.emplace_back(action);
+		record.microseconds.emplace_back(std::chrono::duration_cast<std::chrono::microseconds>(diff).count());
+		state.advance(action);
+	}
+	return record;
+}
+
+// t@Cgame_indexǖڂturnڂ܂ōČĕ\
+void replayGame(const std::string& path, const int game_index, const int turn) {
+	using std::cout; using std::endl;
+	std::ifstream ifs(path);
+	GameRecord record;
+	for (int i = 0; i <= game_index; i++) {
+		if (!record.read(ifs))throw std::string("no game record ") + std::to_string(game_index) + " in " + path;
+	}
+	cout << "turn " << turn << " / " << record.actions.size() << endl;
+	if (turn > 0 && turn <= (int)record.actions.size())
+		cout << "action " << record.actions[turn - 1] << " (" << record.microseconds[turn - 1] << "us)" << endl;
+	cout << record.replay(turn).toString() << endl;
+}
+
+#ifndef _WIN32
+// configurations[task.configuration]AȊg1ǃvCAũXRA v1sԂ
+std::string playFarmGame(const std::vector<std::vector<StringAIPair>>& configurations, const farm::Task& task) {
+	mt.seed(task.seed);
+	const auto record = recordGame(configurations[task.configuration]);
+	std::stringstream ss;
+	ss << record.replay((int)record.actions.size()).getFirstPlayerScoreForWinRate() << ' ';
+	record.write(ss);
+	std::string result = ss.str();
+	result.pop_back(); // writets
+	return result;
+}
+
+// R[fBl[^[Ƃđ҂󂯁AʂɋN[J[game_numberǂ𕪒SČʂresult_pathɒǋL
+void runFarmCoordinator(const std::string& socket_path, const std::string& result_path, const int game_number, const int configuration_number) {
+	farm::Coordinator coordinator(socket_path, result_path, game_number, configuration_number);
+	while (!coordinator.isFinished()) {
+		coordinator.step(farm::POLL_INTERVAL);
+	}
+	coordinator.shutdown();
+	std::cout << coordinator.summary();
+}
+
+// [J[ƂăR[fBl[^[ɐڑAnꂽԍAȊgőΐ킵
+void runFarmWorker(const std::string& socket_path, const std::vector<std::vector<StringAIPair>>& configurations) {
+	farm::runWorker(socket_path, [&](const farm::Task& task) { return playFarmGame(configurations, task); });
+}
+
+// R[fBl[^[worker_number̃[J[vZXNAconfigurations̊eAȊggame_numberǂ𕪒S
+// rŏI[J[͋NBʃt@CcĂ΁AIĂȂǂĊJ
+void runFarm(const std::string& socket_path, const std::string& result_path, const int game_number, const std::vector<std::vector<StringAIPair>>& configurations, const int worker_number) {
+	farm::Coordinator coordinator(socket_path, result_path, game_number, (int)configurations.size());
+	std::vector<pid_t> pids;
+	const auto spawn = [&]() {
+		const pid_t pid = fork();
+		if (pid < 0)
+			throw std::string("cannot fork worker");
+		if (pid == 0) {
+			coordinator.releaseSockets();
+			try {
+				runFarmWorker(socket_path, configurations);
+			}
+			catch (const std::string& error) {
+				std::cerr << error << std::endl;
+				_exit(1);
+			}
+			_exit(0);
+		}
+		pids.emplace_back(pid);
+	};
+	for (int i = 0; i < worker_number && !coordinator.isFinished(); i++) {
+		spawn();
+	}
+	while (!coordinator.isFinished()) {
+		coordinator.step(farm::POLL_INTERVAL);
+		pid_t pid;
+		while ((pid = waitpid(-1, nullptr, WNOHANG)) > 0) {
+			pids.erase(std::remove(pids.begin(), pids.end(), pid), pids.end());
+			if (!coordinator.isFinished()) {
+				std::cerr << "worker " << pid << " exited, restarting" << std::endl;
+				spawn();
+			}
+		}
+	}
+	// SďÎŁAڑ҂̃[J[ɂI`A܂ڑĂȂ[J[͎~߂
+	coordinator.shutdown();
+	for (const auto pid : pids) {
+		kill(pid, SIGTERM);
+		waitpid(pid, nullptr, 0);
+	}
+	std::cout << coordinator.summary();
+}
+#endif
+
+// m䌟(SPRT)ŁA1sƂ̓_̕ςmean0mean1𔻒肷NX
+// _͐KzŋߎAU͊ϑl琄肷
+class SequentialTest {
+private:
+	double mean0_; // A̕
+	double mean1_; // Η̕
+	double lower_bound_; // ΐޓx䂪Ȃ
+	double upper_bound_; // ΐޓx䂪Η̑
+	int n_;
+	double sum_;
+	double square_sum_;
+
+	// SȂǂŕU0ɂȂƔłȂ߁A̕ς1񂸂ϑ̂ƂĕU𐄒肷
+	double regularizedVariance()const {
+		const double n = this->n_ + 2;
+		const double mean = (this->sum_ + this->mean0_ + this->mean1_) / n;
+		return std::max(0.0, (this->square_sum_ + this->mean0_ * this->mean0_ + this->mean1_ * this->mean1_) / n - mean * mean);
+	}
+
+public:
+	enum Result {
+		CONTINUE,
+		ACCEPT_H0,
+		ACCEPT_H1,
+	};
+
+	// AƑΗ̕ρA1̌藦alphaA2̌藦betaw肵ăCX^X
+	SequentialTest(const double mean0, const double mean1, const double alpha, const double beta) :
+		mean0_(mean0),
+		mean1_(mean1),
+		lower_bound_(log(beta / (1 - alpha))),
+		upper_bound_(log((1 - beta) / alpha)),
+		n_(0),
+		sum_(0),
+		square_sum_(0)
+	{
+
+	}
+
+	// 1s̓_ǉ
+	void add(const double score) {
+		this->n_++;
+		this->sum_ += score;
+		this->square_sum_ += score * score;
+	}
+
+	// s񐔂Ԃ
+	int size()const {
+		return this->n_;
+	}
+
+	// _̕ςԂ
+	double mean()const {
+		return this->n_ == 0 ? 0 : this->sum_ / this->n_;
+	}
+
+	// _̕ς̐MԂ̔ԂBz͐Kz̕ʓ_ŁA1.96Ȃ95%M
+	double margin(const double z = 1.96)const {
+		if (this->n_ == 0)return 0;
+		return z * sqrt(this->regularizedVariance() / this->n_);
+	}
+
+	// ΐޓxԂB2sł0
+	double llr()const {
+		const double variance = this->regularizedVariance();
+		if (this->n_ < 2 || variance <= 0)return 0;
+		return (this->mean1_ - this->mean0_) * (2 * this->sum_ - this->n_ * (this->mean0_ + this->mean1_)) / (2 * variance);
+	}
+
+	// _̌茋ʂԂ
+	Result result()const {
+		const double llr = this->llr();
+		if (llr <= this->lower_bound_)return ACCEPT_H0;
+		if (llr >= this->upper_bound_)return ACCEPT_H1;
+		return CONTINUE;
+	}
+
+	double lowerBound()const {
+		return this->lower_bound_;
+	}
+
+	double upperBound()const {
+		return this->upper_bound_;
+	}
+};
+
+// Eloғ_(1A0.5A0)ɕϊ
+double eloToScore(const double elo) {
+	return 1.0 / (1.0 + pow(10.0, -elo / 400.0));
+}
+
+// ғ_EloɕϊB01͗L̒lɊۂ߂
+double scoreToElo(const double score) {
+	const double clamped_score = std::min(std::max(score, 1e-6), 1 - 1e-6);
+	return -400.0 * log10(1.0 / clamped_score - 1.0);
+}
+
+// _̕ςƐMԂ̔AElǒ덷Ԃ
+double eloMargin(const double mean, const double margin) {
+	return (scoreToElo(mean + margin) - scoreToElo(mean - margin)) / 2;
 }
 
 // Q[game_number~2()vCais0ԖڂAȈ\B
@@ -555,9 +2805,6 @@ void testFirstPlayerWinRate(const std::vector<StringAIPair>& ais, const int game
 			}
 			double win_rate_point = state.getFirstPlayerScoreForWinRate();
 			if (j == 1)win_rate_point = 1 - win_rate_point;
-			if (win_rate_point >= 0) {
-				state.toString();
-			}
 			first_player_win_rate += win_rate_point;
 
 
@@ -568,9 +2815,85 @@ void testFirstPlayerWinRate(const std::vector<StringAIPair>& ais, const int game
 	first_player_win_rate /= (double)(game_number * 2);
 	cout << "Winning rate of " << ais[0].first << " to " << ais[1].first << ":\t" << first_player_win_rate << endl;
 }
+
+// Eloelo0AAelo1ΗƂSPRTŁALӂɂȂ܂ōőmax_game_number~2()vCA
+// ais0ԖڂAȈElo\B
+void testFirstPlayerWinRateWithSprt(const std::vector<StringAIPair>& ais, const int max_game_number, const double elo0, const double elo1, const double alpha = 0.05, const double beta = 0.05) {
+	using std::cout; using  std::endl;
+
+	auto test = SequentialTest(eloToScore(elo0), eloToScore(elo1), alpha, beta);
+	for (int i = 0; i < max_game_number; i++) {
+		for (int j = 0; j < 2; j++) {//蕽ɍs߁A2ǂƂɍs
+			auto state = State();
+			auto& first_ai = ais[j];
+			auto& second_ai = ais[(j + 1) % 2];
+			while (true) {
+				state.advance(first_ai.second(state));
+				if (state.isDone())break;
+				state.advance(second_ai.second(state));
+				if (state.isDone())break;
+			}
+			double win_rate_point = state.getFirstPlayerScoreForWinRate();
+			if (j == 1)win_rate_point = 1 - win_rate_point;
+			test.add(win_rate_point);
+		}
+		cout << "i " << i << " w " << test.mean()
+			<< " elo " << scoreToElo(test.mean()) << " +- " << eloMargin(test.mean(), test.margin())
+			<< " llr " << test.llr() << " [" << test.lowerBound() << ", " << test.upperBound() << "]" << endl;
+		if (test.result() != SequentialTest::CONTINUE)break;
+	}
+	const auto result = test.result();
+	cout << "Winning rate of " << ais[0].first << " to " << ais[1].first << ":\t" << test.mean()
+		<< "\telo " << scoreToElo(test.mean()) << " +- " << eloMargin(test.mean(), test.margin())
+		<< "\t" << (result == SequentialTest::ACCEPT_H1 ? "H1" : result == SequentialTest::ACCEPT_H0 ? "H0" : "no decision")
+		<< " after " << test.size() << " games" << endl;
+}
+// MCTS-Solveȑؖ̓`m߂Bǖʂ̃[gWJAqm[h̏ؖς݂̒lă[g̒l𒲂ׂ
+void testMctsSolverProof() {
+	using montecarlo::Tree;
+	using montecarlo::Proof;
+	auto tree = Tree(State(), 0);
+	tree.expandRoot();
+	const int begin = tree.child_begin_[0];
+	const int end = begin + tree.child_size_[0];
+	if (end - begin < 2)
+		throw std::string("root has too few children");
+	const auto check = [&](const char* name, const Proof expected) {
+		const Proof proof = tree.proveFromChildren(0);
+		std::cout << name << ":\t" << (proof == expected ? "ok" : "NG") << std::endl;
+		if (proof != expected)
+			throw std::string("wrong proof in ") + name;
+	};
+
+	// ؖ̎q̌ɏ̎(ؖ̕ꂽq)
+	std::fill(tree.proofs_.begin() + begin, tree.proofs_.begin() + end, montecarlo::UNPROVEN);
+	tree.proofs_[end - 1] = montecarlo::PROVEN_LOSS;
+	check("win after unproven", montecarlo::PROVEN_WIN);
+
+	// ̎̒ɖؖ̎q1cĂ
+	std::fill(tree.proofs_.begin() + begin, tree.proofs_.begin() + end, montecarlo::PROVEN_WIN);
+	tree.proofs_[end - 1] = montecarlo::UNPROVEN;
+	check("unproven among losses", montecarlo::UNPROVEN);
+
+	// Sďؖς݂ŁA̎肪
+	tree.proofs_[end - 1] = montecarlo::PROVEN_DRAW;
+	check("draw among losses", montecarlo::PROVEN_DRAW);
+
+	// SĂ̎肪
+	tree.proofs_[end - 1] = montecarlo::PROVEN_WIN;
+	check("all losses", montecarlo::PROVEN_LOSS);
+}
+
 int main() {
 	using std::cout; using  std::endl;
 
+	MctsSearcher mcts_searcher; // Ԃ܂ŒT؂p߁AAI̊Oŕێ
+	//mcts_searcher.setPondering(true); // ̎ԒTBAICPU荇̂ŁA̔rɂ͎gȂ
+	//mcts_searcher.setNodeBudget(NodeBudget{/*m[h*/0,/*oCg*/64 << 20,/*ŕ؂̂Ă邩*/true}); // T؂̃64MiB܂łɗ}
+	//runSelfPlay("alternate_selfplay.bin",/*ΐ퐔*/10000,/*1肠̃vCAEg*/1000,/*Xbh*/std::thread::hardware_concurrency()); // wKf[^
+	//Evaluator::load("evaluator_weights.txt"); // ]֐ŃRpCƂ͏d݂ǂݍ
+	//endgametable::Solver<State> solver; solver.solve(State()); solver.write("tictactoe.egtb"); // IՃf[^x[X
+	//endgametable::Table<State> endgame_table("tictactoe.egtb");
 	std::vector<StringAIPair> ais = {
 		//StringAIPair("miniMaxAction",[](const State& state) {return miniMaxAction(state,3); }),
 		//StringAIPair("randomAction",[](const State& state) {return randomAction(state); }),
@@ -578,11 +2901,22 @@ int main() {
 		StringAIPair("primitiveMontecarloAction",[](const State& state) {return primitiveMontecarloAction(state,1000); }),
 		//StringAIPair("mctsActionWithTimeThreshold",[](const State& state) {return mctsActionWithTimeThreshold(state,10); }),
 		//StringAIPair("mctsActionWithTimeThreshold10",[](const State& state) {return mctsActionWithTimeThreshold(state,100); }),
+		//StringAIPair("mctsActionWithNodeBudget",[](const State& state) {TreeStatistics statistics; const auto action = mctsActionWithTimeThreshold(state,10,NodeBudget{/*m[h*/100000,/*oCg*/0,/*ŕ؂̂Ă邩*/true},&statistics); std::cerr << "nodes " << statistics.node_number << " bytes " << statistics.byte_size << " pruned " << statistics.pruned_node_number << std::endl; return action; }),
+		//StringAIPair("mctsSearcherWithTimeThreshold",[&](const State& state) {return mcts_searcher.actionWithTimeThreshold(state,10); }),
 		//StringAIPair("primitiveMontecarloActionWithTimeThreshold",[](const State& state) {return primitiveMontecarloActionWithTimeThreshold(state,1); }),
 		//StringAIPair("alphaBetaAction",[](const State& state) {return alphaBetaAction(state,-1); }),
 		//StringAIPair("iterativeDeepningAction",[](const State& state) {return iterativeDeepningAction(state,10); }),
+		//StringAIPair("endgameTableAction",[&](const State& state) {return endgameTableAction(endgame_table, state); }),
 	};
 	playGame(ais);
+	//playGame(ais,/*^[Ֆʂ\邩*/false); // Ֆʂ̕\Ōゾɂđ΋ǂ𑬂
+	//{ std::ofstream record_stream("game_records.txt"); for (int i = 0; i < 100; i++) recordGame(ais).write(record_stream); } // Ֆʂ\ɊL^
+	//replayGame("game_records.txt",/**/0,/*萔*/3); // L^̔ՖʂČ
+	//runFarm("/tmp/alternate_farm.sock", "farm_results.txt",/*ΐ퐔*/1000, { ais, { ais[1], ais[0] } },/*[J[*/std::thread::hardware_concurrency()); // ւ2̑g𕡐vZXőΐ킷
+	//runFarmCoordinator("/tmp/alternate_farm.sock", "farm_results.txt",/*ΐ퐔*/1000,/*AȊg̐*/2); // [J[͕ʂɋN(numactlNUMAm[hƂɋNȂ)
+	//runFarmWorker("/tmp/alternate_farm.sock", { ais, { ais[1], ais[0] } }); // R[fBl[^[ƓAȊgn
+	//testMctsSolverProof(); // MCTS-Solveȑؖ̓`m߂
 	//testFirstPlayerWinRate(ais,10);
+	//testFirstPlayerWinRateWithSprt(ais,/*őΐ*/1000,/*AElo*/0,/*ΗElo*/50);
 	return 0;
 }
\ No newline at end of file
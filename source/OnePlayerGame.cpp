@@ -10,6 +10,27 @@
 #include<chrono>
 #include <queue>
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <deque>
+#include <filesystem>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <signal.h>
+#endif
 std::random_device rnd;
 std::mt19937 mt(rnd());
 
@@ -18,27 +39,157 @@ using Actions = std::vector<int>;
 using ScoreType = int64_t;
 constexpr const ScoreType INF = 1000000000LL;
 // ԂǗNX
+// Ԑ̕ύXƒf͕ʃXbhs
 class TimeKeeper {
 private:
 	std::chrono::high_resolution_clock::time_point start_time_;
-	int64_t time_threshold_;
+	std::atomic<int64_t> time_threshold_;
+	std::atomic<bool> is_canceled_;
 
 public:
 
 	// Ԑ~bPʂŎw肵ăCX^XB
 	TimeKeeper(const int64_t& time_threshold)
 		:start_time_(std::chrono::high_resolution_clock::now()),
-		time_threshold_(time_threshold)
+		time_threshold_(time_threshold),
+		is_canceled_(false)
 	{
 
 	}
 
-	// CX^Xw肵Ԑ𒴉߂fB
+	// CX^Xw肵Ԑ𒴉߂AfꂽfB
 	bool isTimeOver() const {
+		if (this->is_canceled_)return true;
 		auto diff = std::chrono::high_resolution_clock::now() - this->start_time_;
 		return std::chrono::duration_cast<std::chrono::milliseconds>(diff).count() >= time_threshold_;
 	}
 
+	// CX^X̎Ԑ~bPʂŕύXB
+	void setTimeThreshold(const int64_t time_threshold) {
+		this->time_threshold_ = time_threshold;
+	}
+
+	// Ԑ҂ɒfB
+	void cancel() {
+		this->is_canceled_ = true;
+	}
+
+};
+
+// 񓯊T̓ro
+struct SearchProgress {
+	std::atomic<Action> best_action_; // _̍őP
+	std::atomic<int64_t> iteration_; // ̐(T̐[vCAEg)
+
+	SearchProgress() :best_action_(-1), iteration_(0) {}
+
+	// ro߂XV
+	void update(const Action best_action, const int64_t iteration) {
+		this->best_action_ = best_action;
+		this->iteration_ = iteration;
+	}
+};
+
+// TƂɎyʂȗ(xoshiro128++)
+class Xoshiro128 {
+private:
+	uint32_t s_[4];
+
+	static uint32_t rotl(const uint32_t x, const int k) {
+		return (x << k) | (x >> (32 - k));
+	}
+
+public:
+	using result_type = uint32_t;
+
+	// V[hw肵ăCX^XBԂsplitmix64ŏ
+	explicit Xoshiro128(uint64_t seed = 0) {
+		for (int i = 0; i < 4; i += 2) {
+			uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			z ^= z >> 31;
+			this->s_[i] = (uint32_t)z;
+			this->s_[i + 1] = (uint32_t)(z >> 32);
+		}
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return UINT32_MAX; }
+
+	result_type operator()() {
+		const uint32_t result = rotl(this->s_[0] + this->s_[3], 7) + this->s_[0];
+		const uint32_t t = this->s_[1] << 9;
+		this->s_[2] ^= this->s_[0];
+		this->s_[3] ^= this->s_[1];
+		this->s_[1] ^= this->s_[2];
+		this->s_[0] ^= this->s_[3];
+		this->s_[2] ^= t;
+		this->s_[3] = rotl(this->s_[3], 11);
+		return result;
+	}
+};
+
+// ĤQ[ɕωȂǂƏ|CgBՖʂRs[Ă͋L
+// Ht@Cǂݍ񂾏ꍇmmap̈Rs[ɂ̂܂܎QƂ
+struct MazeBoard {
+	int h_ = 0; // H̍
+	int w_ = 0; // H̕
+	int end_turn_ = 0; // Q[I^[
+	int start_y_ = 0; // LN^[̏yW
+	int start_x_ = 0; // LN^[̏xW
+	const uint8_t* walls_ = nullptr; // ǂꏊ1ŕ\By*w+x̏ɕׂ
+	const uint8_t* points_ = nullptr; // ̏|Cg0~9ŕ\By*w+x̏ɕׂ
+	std::vector<uint8_t> buffer_; // HƁAmmapłȂHt@C̎
+	std::shared_ptr<const void> mapping_; // mmap̈BŌɎQƂՖʂmunmap
+
+	MazeBoard() = default;
+	MazeBoard(const MazeBoard&) = delete;
+	MazeBoard& operator=(const MazeBoard&) = delete;
+};
+
+// |Cg}Xy*w+xŎW
+// 1^[Ɏ̂̓LN^[1l1}X܂łȂ̂ŁAI^[~LN^[ɊmۂĂ
+// Rs[Ămۗʂp̂ŁAՖʂi߂ƂvCAEg̓rŃq[vmۂȂ
+class EatenSquares {
+private:
+	std::vector<int> indices_;
+
+public:
+	EatenSquares() = default;
+	EatenSquares(EatenSquares&&) = default;
+	EatenSquares& operator=(EatenSquares&&) = default;
+
+	EatenSquares(const EatenSquares& other) {
+		*this = other;
+	}
+
+	EatenSquares& operator=(const EatenSquares& other) {
+		if (this != &other) {
+			this->indices_.reserve(other.indices_.capacity());
+			this->indices_.assign(other.indices_.begin(), other.indices_.end());
+		}
+		return *this;
+	}
+
+	// }X̐̏mۂ
+	void reserve(const int capacity) {
+		this->indices_.reserve(capacity);
+	}
+
+	// }Xindex̃|Cg肷
+	bool contains(const int index)const {
+		return std::binary_search(this->indices_.begin(), this->indices_.end(), index);
+	}
+
+	// }XindexAVԂ
+	bool insert(const int index) {
+		auto it = std::lower_bound(this->indices_.begin(), this->indices_.end(), index);
+		if (it != this->indices_.end() && *it == index)
+			return false;
+		this->indices_.insert(it, index);
+		return true;
+	}
 };
 
 // lQ[̗
@@ -46,6 +197,9 @@ public:
 // ɂ|Cg𓥂ނƎg̃XRAƂȂÃ|CgB
 // END_TURN̎_̃XRA邱ƂړI
 class MazeState {
+public:
+	static constexpr const int MAX_ACTION_NUMBER = 4; // 1^[ɉ\ȍs̍ő吔
+
 private:
 	static constexpr const int dx[4] = { 1,-1,0,0 };
 	static constexpr const int dy[4] = { 0,0,1,-1 };
@@ -60,8 +214,8 @@ private:
 	int h_; // H̍
 	int w_; // H̕
 	int END_TURN_; // Q[I^[
-	std::vector<std::vector<int>>walls_; // ǂꏊ1ŕ\
-	std::vector<std::vector<int>>points_; // ̃|Cg1~9ŕ\
+	std::shared_ptr<const MazeBoard> board_; // ǂƏ|Cg
+	EatenSquares eaten_; // |Cg}X
 	int turn_; // ݂̃^[
 	Character character_;
 
@@ -70,19 +224,47 @@ private:
 		return(this->character_.y_ == y && this->character_.x_ == x);
 	}
 
+	// W(y,x)ɕǂ邩肷
+	bool isWall(const int y, const int x)const {
+		return this->board_->walls_[y * this->w_ + x];
+	}
+
+	// W(y,x)̏ɎcĂ|CgԂ
+	int pointAt(const int y, const int x)const {
+		const int index = y * this->w_ + x;
+		const int point = this->board_->points_[index];
+		if (point == 0 || this->eaten_.contains(index)) {
+			return 0;
+		}
+		return point;
+	}
+
 public:
 	int game_score_; // Q[ŎۂɓXRA
 	ScoreType evaluated_score_; // Tŕ]XRA
 	Action first_action_;// T؂̃[gm[hōŏɐ󂵂s
 	MazeState() {}
 
+	// ǂƏ|CgLH珉Ֆʂ
+	explicit MazeState(const std::shared_ptr<const MazeBoard>& board) :
+		h_(board->h_),
+		w_(board->w_),
+		END_TURN_(board->end_turn_),
+		board_(board),
+		turn_(0),
+		character_(board->start_y_, board->start_x_),
+		game_score_(0),
+		evaluated_score_(0),
+		first_action_(-1)
+	{
+		this->eaten_.reserve(this->END_TURN_);
+	}
+
 	// h*w̖H𐶐B
 	MazeState(const int h, const int w,const int end_turn, const int seed) :
 		h_(h),
 		w_(w),
 		END_TURN_(end_turn),
-		walls_(h, std::vector<int>(w)),
-		points_(h, std::vector<int>(w)),
 		turn_(0),
 		character_(h / 2, w / 2),
 		game_score_(0),
@@ -92,6 +274,18 @@ public:
 		if (h % 2 == 0 || w % 2 == 0) {
 			throw std::string("h and w must be odd number");
 		}
+		this->eaten_.reserve(end_turn);
+		auto board = std::make_shared<MazeBoard>();
+		board->h_ = h;
+		board->w_ = w;
+		board->end_turn_ = end_turn;
+		board->start_y_ = character_.y_;
+		board->start_x_ = character_.x_;
+		board->buffer_.assign(2 * h * w, 0);
+		uint8_t* walls = board->buffer_.data();
+		uint8_t* points = walls + h * w;
+		board->walls_ = walls;
+		board->points_ = points;
 		auto mt = std::mt19937(seed);
 
 		auto check = std::vector<std::vector<int>>(h, std::vector<int>(w));
@@ -102,7 +296,7 @@ public:
 				int ty = y;
 				int tx = x;
 				if (!check[ty][tx]) {
-					this->walls_[ty][tx] = 1;
+					walls[ty * w + tx] = 1;
 					check[ty][tx] = 1;
 				}
 				if (mt() % 10 > 50) {
@@ -110,7 +304,7 @@ public:
 					ty += dy[direction];
 					tx += dx[direction];
 					if (!check[ty][tx]) {
-						this->walls_[ty][tx] = 1;
+						walls[ty * w + tx] = 1;
 						check[ty][tx] = 1;
 					}
 				}
@@ -118,11 +312,16 @@ public:
 		for (int y = 0; y < h; y++)
 			for (int x = 0; x < w; x++) {
 				if (!check[y][x]) {
-					this->points_[y][x] = mt() % 10;
+					points[y * w + x] = mt() % 10;
 					check[y][x] = 1;
 				}
 			}
+		this->board_ = std::move(board);
+	}
 
+	// ǂƏ|CgԂ
+	const std::shared_ptr<const MazeBoard>& board()const {
+		return this->board_;
 	}
 
 	// [ǂ̃Q[ł] : Tp̔Ֆʕ]
@@ -139,10 +338,10 @@ public:
 	void advance(const Action& action) {
 		this->character_.x_ += dx[action];
 		this->character_.y_ += dy[action];
-		auto& point = this->points_[this->character_.y_][this->character_.x_];
-		if (point > 0) {
+		const int index = this->character_.y_ * this->w_ + this->character_.x_;
+		const int point = this->board_->points_[index];
+		if (point > 0 && this->eaten_.insert(index)) {
 			this->game_score_ += point;
-			point = 0;
 		}
 		this->turn_++;
 
@@ -155,13 +354,46 @@ public:
 			int ty = this->character_.y_ + dy[action];
 			int tx = this->character_.x_ + dx[action];
 			if (ty >= 0 && ty < h_ && tx >= 0 && tx < w_
-				&& !this->walls_[ty][tx]) {
+				&& !this->isWall(ty, tx)) {
 				actions.emplace_back(action);
 			}
 		}
 		return actions;
 	}
 
+	// [ȂĂ悢ƕ֗] : ݂̏󋵂ŃvC[\ȍsq[vg킸actions֏݁A̐Ԃ
+	int legalActions(Action* actions)const {
+		int action_number = 0;
+		for (Action action = 0; action < 4; action++) {
+			int ty = this->character_.y_ + dy[action];
+			int tx = this->character_.x_ + dx[action];
+			if (ty >= 0 && ty < h_ && tx >= 0 && tx < w_
+				&& !this->isWall(ty, tx)) {
+				actions[action_number++] = action;
+			}
+		}
+		return action_number;
+	}
+
+	// [ȂĂ悢ƕ֗] : wKf[^ɏoՖʂ̃oCgԂ
+	int encodedSize()const {
+		return 6 * sizeof(int32_t) + 2 * this->h_ * this->w_;
+	}
+
+	// [ȂĂ悢ƕ֗] : wKf[^ɏo߁AՖʂbytesɏ
+	// AA^[ALN^[yWxWAXRAint32_tŕׁAĊe}X̃|Cgƕǂ1oCgׂ
+	void encode(uint8_t* bytes)const {
+		const int32_t values[6] = { this->h_, this->w_, this->turn_, this->character_.y_, this->character_.x_, this->game_score_ };
+		std::memcpy(bytes, values, sizeof(values));
+		bytes += sizeof(values);
+		for (int y = 0; y < this->h_; y++) {
+			for (int x = 0; x < this->w_; x++) {
+				bytes[y * this->w_ + x] = (uint8_t)this->pointAt(y, x);
+			}
+		}
+		std::memcpy(bytes + this->h_ * this->w_, this->board_->walls_, this->h_ * this->w_);
+	}
+
 	// [ȂĂ悢ƕ֗] : ݂̃Q[󋵂𕶎ɂ
 	std::string toString()const {
 		std::stringstream ss;
@@ -170,14 +402,14 @@ public:
 		for (int h = 0; h < this->h_; h++) {
 			for (int w = 0; w < this->w_; w++) {
 				char c = '.';
-				if (this->walls_[h][w]) {
+				if (this->isWall(h, w)) {
 					c = '#';
 				}
 				if (this->character_.y_ == h && this->character_.x_ == w) {
 					c = '@';
 				}
-				if (this->points_[h][w]) {
-					c = '0' + (char)points_[h][w];
+				if (this->pointAt(h, w)) {
+					c = '0' + (char)this->pointAt(h, w);
 				}
 				ss << c;
 			}
@@ -201,6 +433,25 @@ Action randomAction(const State& state) {
 	return legal_actions[mt() % (legal_actions.size())];
 }
 
+// TƂ̗gAq[vg킸Ƀ_ɍs肷
+Action randomAction(const State& state, Xoshiro128& rng) {
+	Action legal_actions[State::MAX_ACTION_NUMBER];
+	const int action_number = state.legalActions(legal_actions);
+	return legal_actions[rng() % action_number];
+}
+
+// _vCAEgăQ[ĨXRAvZ
+// ċAɃ[vŐi߁Aq[vmۂȂBsequencenƑI񂾍sǋL
+int playout(State* state, Xoshiro128& rng, Actions* sequence = nullptr) {
+	while (!state->isDone()) {
+		const Action action = randomAction(*state, rng);
+		if (sequence != nullptr)
+			sequence->emplace_back(action);
+		state->advance(action);
+	}
+	return state->game_score_;
+}
+
 // ×~@ōs肷
 Action greedyAction(const State& state) {
 	auto legal_actions = state.legalActions();
@@ -252,9 +503,8 @@ Action beamSearchAction(const State& state, const int beam_width, const int beam
 	return best_state.first_action_;
 }
 
-// r[Ɛ(ms)w肵ăr[T[`ōs肷
-Action beamSearchActionWithTimeThreshold(const State& state, const int beam_width, const int64_t time_threshold) {
-	auto time_keeper = TimeKeeper(time_threshold);
+// time_keeper~߂܂Ńr[T[`ŒTA[Ƃ̍őPprogressɏ
+Action beamSearchActionWithTimeKeeper(const State& state, const int beam_width, const TimeKeeper& time_keeper, SearchProgress* progress = nullptr) {
 	auto legal_actions = state.legalActions();
 	std::priority_queue<State> now_beam;
 	State best_state;
@@ -280,6 +530,8 @@ Action beamSearchActionWithTimeThreshold(const State& state, const int beam_widt
 
 		now_beam = next_beam;
 		best_state = now_beam.top();
+		if (progress != nullptr)
+			progress->update(best_state.first_action_, t + 1);
 
 
 		if (best_state.isDone())
@@ -290,6 +542,12 @@ Action beamSearchActionWithTimeThreshold(const State& state, const int beam_widt
 	return best_state.first_action_;
 }
 
+// r[Ɛ(ms)w肵ăr[T[`ōs肷
+Action beamSearchActionWithTimeThreshold(const State& state, const int beam_width, const int64_t time_threshold) {
+	auto time_keeper = TimeKeeper(time_threshold);
+	return beamSearchActionWithTimeKeeper(state, beam_width, time_keeper);
+}
+
 // r[1{̃r[ƃr[̖{w肵chokudaiT[`ōs肷
 Action chokudaiSearchAction(const State& state, const int beam_width, const int beam_depth, const int beam_number) {
 	auto beam = std::vector<std::priority_queue<State>>(beam_depth + 1);
@@ -329,15 +587,14 @@ Action chokudaiSearchAction(const State& state, const int beam_width, const int
 	return -1;
 }
 
-// r[1{̃r[Ɛ(ms)w肵chokudaiT[`ōs肷
-Action chokudaiSearchActionWithTimeThreshold(const State& state, const int beam_width, const int beam_depth, const int64_t time_threshold) {
-	auto time_keeper = TimeKeeper(time_threshold);
+// time_keeper~߂܂chokudaiT[`ŒTA񂲂Ƃ̍őPprogressɏ
+Action chokudaiSearchActionWithTimeKeeper(const State& state, const int beam_width, const int beam_depth, const TimeKeeper& time_keeper, SearchProgress* progress = nullptr) {
 	auto beam = std::vector<std::priority_queue<State>>(beam_depth + 1);
 	for (int t = 0; t < beam_depth + 1; t++) {
 		beam[t] = std::priority_queue<State>();
 	}
 	beam[0].push(state);
-	for (;;) {
+	for (int cnt = 0;; cnt++) {
 		for (int t = 0; t < beam_depth; t++) {
 			auto& now_beam = beam[t];
 			auto& next_beam = beam[t + 1];
@@ -358,6 +615,14 @@ Action chokudaiSearchActionWithTimeThreshold(const State& state, const int beam_
 				}
 			}
 		}
+		if (progress != nullptr) {
+			for (int t = beam_depth; t >= 1; t--) {
+				if (!beam[t].empty()) {
+					progress->update(beam[t].top().first_action_, cnt + 1);
+					break;
+				}
+			}
+		}
 		if (time_keeper.isTimeOver()) {
 			break;
 		}
@@ -371,24 +636,1429 @@ Action chokudaiSearchActionWithTimeThreshold(const State& state, const int beam_
 
 	return -1;
 }
+
+// r[1{̃r[Ɛ(ms)w肵chokudaiT[`ōs肷
+Action chokudaiSearchActionWithTimeThreshold(const State& state, const int beam_width, const int beam_depth, const int64_t time_threshold) {
+	auto time_keeper = TimeKeeper(time_threshold);
+	return chokudaiSearchActionWithTimeKeeper(state, beam_width, beam_depth, time_keeper);
+}
+namespace nestedmontecarlo {
+	// w肵xNested Monte Carlo SearchŁAstateIǂ܂ł̍ŗǂ̍sbest_sequenceɏ݁ÃXRAԂ
+	// x0̓_vCAEgŁAxL͊ěxL-1ŕ]čŗǂ̍sɉ1肸i
+	// time_keepernƐԂ𒴂_őł؂A܂łɌŗǂԂ
+	int nestedScore(const State& state, const int level, Xoshiro128& rng, Actions* best_sequence, const TimeKeeper* time_keeper = nullptr) {
+		best_sequence->clear();
+		if (level == 0 || state.isDone()) {
+			State playout_state = state;
+			return playout(&playout_state, rng, best_sequence);
+		}
+		State now_state = state;
+		int best_score = -1;
+		int played_number = 0;
+		Actions sequence;
+		while (!now_state.isDone()) {
+			Action legal_actions[State::MAX_ACTION_NUMBER];
+			const int action_number = now_state.legalActions(legal_actions);
+			for (int i = 0; i < action_number; i++) {
+				State next_state = now_state;
+				next_state.advance(legal_actions[i]);
+				const int score = nestedScore(next_state, level - 1, rng, &sequence, time_keeper);
+				if (score > best_score) {
+					best_score = score;
+					best_sequence->resize(played_number);
+					best_sequence->emplace_back(legal_actions[i]);
+					best_sequence->insert(best_sequence->end(), sequence.begin(), sequence.end());
+				}
+				if (time_keeper != nullptr && time_keeper->isTimeOver())
+					return best_score;
+			}
+			now_state.advance((*best_sequence)[played_number]);
+			++played_number;
+		}
+		return best_score;
+	}
+
+	// xw肵Nested Monte Carlo Searchōs肷
+	Action nestedMonteCarloSearchAction(const State& state, const int level) {
+		Xoshiro128 rng(mt());
+		Actions best_sequence;
+		nestedScore(state, level, rng, &best_sequence);
+		return best_sequence[0];
+	}
+
+	// (ms)w肵āAx1グȂNested Monte Carlo Searchōs肷
+	Action nestedMonteCarloSearchActionWithTimeThreshold(const State& state, const int64_t time_threshold) {
+		auto time_keeper = TimeKeeper(time_threshold);
+		Xoshiro128 rng(mt());
+		int best_score = -1;
+		Actions best_sequence;
+		Actions sequence;
+		for (int level = 1; level <= 1 || !time_keeper.isTimeOver(); level++) {
+			const int score = nestedScore(state, level, rng, &sequence, &time_keeper);
+			if (score > best_score) {
+				best_score = score;
+				best_sequence = sequence;
+			}
+		}
+		return best_sequence[0];
+	}
+}
+using nestedmontecarlo::nestedMonteCarloSearchAction;
+using nestedmontecarlo::nestedMonteCarloSearchActionWithTimeThreshold;
+
+namespace montecarlo {
+	constexpr const double C = 1.; //UCB1̌vZɎg萔
+	constexpr const int EXPAND_THRESHOLD = 10; // m[hWJ臒l
+
+	// T؂̑傫̏Bǂ0ȂȂ
+	struct NodeBudget {
+		int64_t max_node_number = 0; // m[h̏
+		int64_t max_byte_size = 0; // m[h̔zɎgoCg̏
+		bool recycles = false; // ɒB玎s񐔂̏Ȃ؂̂Ăċ󂫂BfalseȂWJ~߂
+	};
+
+	// T؂̃gp
+	struct TreeStatistics {
+		int64_t node_number = 0; // m[h
+		int64_t byte_size = 0; // m[h̔z񂪊mۂĂoCg
+		int64_t pruned_node_number = 0; // 󂫂邽߂Ɏ̂Ăm[h̉א
+	};
+
+	// lQ[pMCTS̒T
+	// σXRAɉĕ؂ŌőXRAt`dAIł͗őXRAŐKĎg
+	// m[h͔zɘAĊi[Aqm[h͐擪CfbNXƌŕ\BՖʂ̓[g̔ՖʂsHĕ
+	class Tree {
+	private:
+		State root_state_;
+		Xoshiro128 rng_; // vCAEgp̗
+		std::vector<int> path_; // ]ɒHm[h̃CfbNX
+		int best_score_; // TŜŌőXRA
+		NodeBudget budget_;
+		int64_t max_node_number_; // budget_狁߂m[h̏B0ȂȂ
+		bool needs_recycle_; // ̂ߓWJłȂm[hA̕]̑Oɋ󂫂
+		int64_t pruned_node_number_;
+
+		// em[hactionőJڂm[hǉ
+		int addNode(const Action action) {
+			this->w_.emplace_back(0);
+			this->n_.emplace_back(0);
+			this->max_scores_.emplace_back(0);
+			this->actions_.emplace_back(action);
+			this->child_begin_.emplace_back(0);
+			this->child_size_.emplace_back(0);
+			return (int)this->n_.size() - 1;
+		}
+
+		// s񐔂min_ñm[h̎q̂ĂƂɎcm[hkeptɈtA̐Ԃ
+		// [g̎q͏ɎcBem[h͎qm[hOɂ̂ŁAO1񑖍΂悢
+		int64_t markKept(const double min_n, std::vector<uint8_t>* kept) const {
+			kept->assign(this->n_.size(), 0);
+			(*kept)[0] = 1;
+			int64_t kept_number = 1;
+			for (int i = 0; i < (int)this->n_.size(); i++) {
+				if (!(*kept)[i] || this->child_size_[i] == 0 || (i != 0 && this->n_[i] < min_n))
+					continue;
+				for (int c = 0; c < this->child_size_[i]; c++) {
+					(*kept)[this->child_begin_[i] + c] = 1;
+				}
+				kept_number += this->child_size_[i];
+			}
+			return kept_number;
+		}
+
+		// s񐔂̏Ȃm[h̎q̂āAm[h̔ȉɂ
+		// cm[h͏Ԃۂ܂ܔz̑Oɋl߂Bl߂̃CfbNX͌ȉȂ̂ŁȀŏ㏑ł
+		void recycle() {
+			const int64_t target = this->max_node_number_ / 2;
+			std::vector<uint8_t> kept;
+			int64_t low = 0;
+			int64_t high = (int64_t)this->n_[0] + 1;
+			while (low < high) {
+				const int64_t mid = (low + high) / 2;
+				if (this->markKept((double)mid, &kept) <= target)
+					high = mid;
+				else
+					low = mid + 1;
+			}
+			const int64_t kept_number = this->markKept((double)low, &kept);
+			std::vector<int> new_ids(this->n_.size(), -1);
+			int next_id = 0;
+			for (int i = 0; i < (int)this->n_.size(); i++) {
+				if (kept[i])
+					new_ids[i] = next_id++;
+			}
+			for (int i = 0; i < (int)this->n_.size(); i++) {
+				const int id = new_ids[i];
+				if (id < 0)
+					continue;
+				const bool has_children = this->child_size_[i] > 0 && kept[this->child_begin_[i]];
+				this->w_[id] = this->w_[i];
+				this->n_[id] = this->n_[i];
+				this->max_scores_[id] = this->max_scores_[i];
+				this->actions_[id] = this->actions_[i];
+				this->child_begin_[id] = has_children ? new_ids[this->child_begin_[i]] : 0;
+				this->child_size_[id] = has_children ? this->child_size_[i] : 0;
+			}
+			this->pruned_node_number_ += (int64_t)this->n_.size() - kept_number;
+			this->w_.resize(kept_number);
+			this->n_.resize(kept_number);
+			this->max_scores_.resize(kept_number);
+			this->actions_.resize(kept_number);
+			this->child_begin_.resize(kept_number);
+			this->child_size_.resize(kept_number);
+			this->needs_recycle_ = false;
+		}
+
+	public:
+		std::vector<double> w_; // XRA̘a
+		std::vector<double> n_;
+		std::vector<int> max_scores_; // ؂ŌőXRA
+		std::vector<Action> actions_; // em[h炱̃m[hɑJڂs
+		std::vector<int> child_begin_; // qm[h̐擪CfbNX
+		std::vector<int> child_size_; // qm[h̐B0Ȃ疢WJ
+
+		// 1m[h̃oCg
+		static constexpr const int64_t NODE_BYTE_SIZE = 2 * sizeof(double) + sizeof(int) + sizeof(Action) + 2 * sizeof(int);
+
+		Tree(const State& state, const uint64_t seed) :root_state_(state), rng_(seed), best_score_(0), max_node_number_(0), needs_recycle_(false), pruned_node_number_(0) {
+			this->addNode(-1);
+		}
+
+		// T؂̑傫̏ݒ肷B̕ɔzmۂAT͊mۂȂ
+		void setNodeBudget(const NodeBudget& budget) {
+			this->budget_ = budget;
+			this->max_node_number_ = budget.max_node_number;
+			if (budget.max_byte_size > 0) {
+				const int64_t max_node_number = std::max<int64_t>(budget.max_byte_size / NODE_BYTE_SIZE, 1);
+				this->max_node_number_ = this->max_node_number_ > 0 ? std::min(this->max_node_number_, max_node_number) : max_node_number;
+			}
+			if (this->max_node_number_ > 0) {
+				this->w_.reserve(this->max_node_number_);
+				this->n_.reserve(this->max_node_number_);
+				this->max_scores_.reserve(this->max_node_number_);
+				this->actions_.reserve(this->max_node_number_);
+				this->child_begin_.reserve(this->max_node_number_);
+				this->child_size_.reserve(this->max_node_number_);
+			}
+		}
+
+		// T؂̃gpʂԂ
+		TreeStatistics statistics()const {
+			TreeStatistics statistics;
+			statistics.node_number = (int64_t)this->n_.size();
+			statistics.byte_size = (int64_t)(this->w_.capacity() * sizeof(double) + this->n_.capacity() * sizeof(double)
+				+ this->max_scores_.capacity() * sizeof(int) + this->actions_.capacity() * sizeof(Action)
+				+ this->child_begin_.capacity() * sizeof(int) + this->child_size_.capacity() * sizeof(int));
+			statistics.pruned_node_number = this->pruned_node_number_;
+			return statistics;
+		}
+
+		// m[hWJAWJłԂBm[h̏𒴂ꍇ̓[gȊOWJȂ
+		bool expand(const int node, const State& state) {
+			Action legal_actions[State::MAX_ACTION_NUMBER];
+			const int action_number = state.legalActions(legal_actions);
+			if (node != 0 && this->max_node_number_ > 0 && (int64_t)this->n_.size() + action_number > this->max_node_number_) {
+				this->needs_recycle_ = this->budget_.recycles;
+				return false;
+			}
+			const int child_begin = (int)this->n_.size();
+			for (int i = 0; i < action_number; i++) {
+				this->addNode(legal_actions[i]);
+			}
+			this->child_begin_[node] = child_begin;
+			this->child_size_[node] = action_number;
+			return true;
+		}
+
+		// [gm[hWJ
+		void expandRoot() {
+			if (this->child_size_[0] == 0 && !this->root_state_.isDone())
+				this->expand(0, this->root_state_);
+		}
+
+		// ǂ̃m[h]邩I
+		int nextChiledNode(const int node) const {
+			const int begin = this->child_begin_[node];
+			const int end = begin + this->child_size_[node];
+			for (int i = begin; i < end; i++) {
+				if (this->n_[i] == 0)
+					return i;
+			}
+			double t = 0;
+			for (int i = begin; i < end; i++) {
+				t += this->n_[i];
+			}
+			const double log_t = std::log(t);
+			const double scale = std::max(this->best_score_, 1);
+			double best_value = -INF;
+			int best_i = -1;
+			for (int i = begin; i < end; i++) {
+				const double value = (0.5 * this->w_[i] / this->n_[i] + 0.5 * this->max_scores_[i]) / scale;
+				const double ucb1_value = value + (double)C * std::sqrt(2. * log_t / this->n_[i]);
+				if (ucb1_value > best_value) {
+					best_i = i;
+					best_value = ucb1_value;
+				}
+			}
+			return best_i;
+		}
+
+		// [g1]s
+		void evaluate() {
+			if (this->needs_recycle_)
+				this->recycle();
+			State state = this->root_state_;
+			int node = 0;
+			this->path_.clear();
+			this->path_.emplace_back(node);
+			while (this->child_size_[node] > 0 && !state.isDone()) {
+				node = this->nextChiledNode(node);
+				state.advance(this->actions_[node]);
+				this->path_.emplace_back(node);
+			}
+			if (!state.isDone() && this->n_[node] + 1 >= EXPAND_THRESHOLD)
+				this->expand(node, state);
+			const int score = playout(&state, this->rng_);
+			this->best_score_ = std::max(this->best_score_, score);
+			for (const auto i : this->path_) {
+				this->w_[i] += score;
+				++this->n_[i];
+				this->max_scores_[i] = std::max(this->max_scores_[i], score);
+			}
+		}
+
+		// [g̎qm[ĥőXRAłsԂBȂ玎s񐔂̑sI
+		Action bestAction() const {
+			const int begin = this->child_begin_[0];
+			const int end = begin + this->child_size_[0];
+			int best_i = begin;
+			for (int i = begin; i < end; i++) {
+				if (std::make_pair(this->max_scores_[i], this->n_[i]) > std::make_pair(this->max_scores_[best_i], this->n_[best_i]))
+					best_i = i;
+			}
+			return this->actions_[best_i];
+		}
+	};
+
+	// vCAEgw肵ĈlQ[pMCTSōs肷
+	Action mctsAction(const State& state, const int playout_number) {
+		Tree tree = Tree(state, mt());
+		tree.expandRoot();
+		for (int i = 0; i < playout_number; i++) {
+			tree.evaluate();
+		}
+		return tree.bestAction();
+	}
+
+	constexpr const int PROGRESS_INTERVAL = 256; // ro߂XVvCAEg̊Ԋu
+
+	// time_keeper~߂܂ňlQ[pMCTSŒTA񐔂Ƃ̍őPprogressɏ
+	// budgetŒT؂̑傫𐧌łAstatisticsnƒTĨgpʂ
+	Action mctsActionWithTimeKeeper(const State& state, const TimeKeeper& time_keeper, SearchProgress* progress = nullptr, const NodeBudget& budget = NodeBudget(), TreeStatistics* statistics = nullptr) {
+		Tree tree = Tree(state, mt());
+		tree.setNodeBudget(budget);
+		tree.expandRoot();
+		for (int cnt = 0; !time_keeper.isTimeOver(); cnt++) {
+			tree.evaluate();
+			if (progress != nullptr && cnt % PROGRESS_INTERVAL == 0)
+				progress->update(tree.bestAction(), cnt + 1);
+		}
+		if (statistics != nullptr)
+			*statistics = tree.statistics();
+		return tree.bestAction();
+	}
+
+	// (ms)w肵ĈlQ[pMCTSōs肷
+	Action mctsActionWithTimeThreshold(const State& state, const int64_t time_threshold, const NodeBudget& budget = NodeBudget(), TreeStatistics* statistics = nullptr) {
+		auto time_keeper = TimeKeeper(time_threshold);
+		return mctsActionWithTimeKeeper(state, time_keeper, nullptr, budget, statistics);
+	}
+}
+using montecarlo::mctsAction;
+using montecarlo::mctsActionWithTimeThreshold;
+using montecarlo::mctsActionWithTimeKeeper;
+using montecarlo::NodeBudget;
+using montecarlo::TreeStatistics;
+
+// ʃXbhŒTi߁Aro߂̎擾AԐ̕ύXAfłnh
+// Ăяo̓ubNisFinishedbestActionŏ󋵂mFł
+class SearchHandle {
+private:
+	TimeKeeper time_keeper_;
+	SearchProgress progress_;
+	std::atomic<bool> is_finished_;
+	std::thread thread_;
+
+public:
+	using SearchFunction = std::function<Action(const TimeKeeper&, SearchProgress*)>;
+
+	// T֐ƎԐ(ms)w肵ĒTJn
+	SearchHandle(const SearchFunction& search, const int64_t time_threshold) :
+		time_keeper_(time_threshold),
+		is_finished_(false)
+	{
+		this->thread_ = std::thread([this, search]() {
+			const Action action = search(this->time_keeper_, &this->progress_);
+			if (action >= 0)
+				this->progress_.best_action_ = action;
+			this->is_finished_ = true;
+			});
+	}
+
+	~SearchHandle() {
+		this->cancel();
+		if (this->thread_.joinable())
+			this->thread_.join();
+	}
+
+	// TI肷
+	bool isFinished()const {
+		return this->is_finished_;
+	}
+
+	// _̍őPԂB܂Ȃ-1
+	Action bestAction()const {
+		return this->progress_.best_action_;
+	}
+
+	// ̐Ԃ
+	int64_t iteration()const {
+		return this->progress_.iteration_;
+	}
+
+	// TJn̎Ԑ(ms)ύX
+	void setTimeThreshold(const int64_t time_threshold) {
+		this->time_keeper_.setTimeThreshold(time_threshold);
+	}
+
+	// T𒆒f
+	void cancel() {
+		this->time_keeper_.cancel();
+	}
+
+	// T̏I҂čőPԂ
+	Action wait() {
+		if (this->thread_.joinable())
+			this->thread_.join();
+		return this->bestAction();
+	}
+};
+
+// r[ƎԐ(ms)w肵ăr[T[`̔񓯊TJn
+std::unique_ptr<SearchHandle> startBeamSearch(const State& state, const int beam_width, const int64_t time_threshold) {
+	return std::make_unique<SearchHandle>([state, beam_width](const TimeKeeper& time_keeper, SearchProgress* progress) {
+		return beamSearchActionWithTimeKeeper(state, beam_width, time_keeper, progress);
+		}, time_threshold);
+}
+
+// r[1{̃r[ƎԐ(ms)w肵chokudaiT[`̔񓯊TJn
+std::unique_ptr<SearchHandle> startChokudaiSearch(const State& state, const int beam_width, const int beam_depth, const int64_t time_threshold) {
+	return std::make_unique<SearchHandle>([state, beam_width, beam_depth](const TimeKeeper& time_keeper, SearchProgress* progress) {
+		return chokudaiSearchActionWithTimeKeeper(state, beam_width, beam_depth, time_keeper, progress);
+		}, time_threshold);
+}
+
+// Ԑ(ms)w肵ĈlQ[pMCTS̔񓯊TJn
+std::unique_ptr<SearchHandle> startMctsSearch(const State& state, const int64_t time_threshold) {
+	return std::make_unique<SearchHandle>([state](const TimeKeeper& time_keeper, SearchProgress* progress) {
+		return mctsActionWithTimeKeeper(state, time_keeper, progress);
+		}, time_threshold);
+}
+
+// ȑΐŊwKf[^
+// t@C̓wb_̌Ƀ`NǋLĂ`ŁA`N͋ǖʂƂ̋L^l߂
+// `N͏IĂ܂Ƃ߂ĒǋL̂ŁArŎ~܂Ẵ`Nǂݔ΂ΉȂ
+namespace selfplay {
+	constexpr const char FILE_MAGIC[8] = "SPDATA1"; // t@C`̎ʎq
+	constexpr const uint32_t CHUNK_MAGIC = 0x4b4e4843; // "CHNK"
+	constexpr const size_t CHUNK_BYTE_SIZE = 1 << 20; // `Nt@Cɏo傫̖ڈ
+
+	// t@C̐擪ɒuwb_
+	struct FileHeader {
+		char magic[8];
+		uint32_t game_id; // ǂ̃Q[̃f[^
+		uint32_t reserved;
+	};
+
+	// `N̐擪ɒuwb_
+	struct ChunkHeader {
+		uint32_t magic;
+		uint32_t record_number;
+		uint64_t byte_size; // ̃wb_`N̑傫
+	};
+
+	// 1ǖʕ̋L^̐擪ɒuwb_
+	// ɍs(int32_t)A(float)AՖ(oCgA4oCgE܂ŋlߕ)
+	struct RecordHeader {
+		uint32_t game_index; // ǖڂ
+		uint32_t state_size; // Ֆʂ̃oCg
+		uint16_t ply; // ڂ
+		uint16_t policy_size; // ̗vf
+		uint8_t action_number; // L^s̐
+		uint8_t reserved[3];
+		float outcome; // ŏI
+	};
+
+	// L^1̃oCgԂ
+	size_t recordByteSize(const RecordHeader& header) {
+		return sizeof(RecordHeader) + header.action_number * sizeof(int32_t) + header.policy_size * sizeof(float) + (header.state_size + 3) / 4 * 4;
+	}
+
+	// ̃Xbh`NPʂŒǋLt@C
+	class Writer {
+	private:
+		std::ofstream ofs_;
+		std::mutex mutex_;
+
+	public:
+		// t@CǋLpɊJAȂwb_
+		Writer(const std::string& path, const uint32_t game_id) :ofs_(path, std::ios::binary | std::ios::app) {
+			if (!this->ofs_)throw std::string("cannot open ") + path;
+			this->ofs_.seekp(0, std::ios::end);
+			if (this->ofs_.tellp() == 0) {
+				FileHeader header{};
+				std::memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+				header.game_id = game_id;
+				this->ofs_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				this->ofs_.flush();
+			}
+		}
+
+		// L^l߂oCg1̃`NƂĒǋL
+		void appendChunk(const std::vector<uint8_t>& records, const uint32_t record_number) {
+			ChunkHeader header{ CHUNK_MAGIC, record_number, records.size() };
+			std::lock_guard<std::mutex> lock(this->mutex_);
+			this->ofs_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			this->ofs_.write(reinterpret_cast<const char*>(records.data()), records.size());
+			this->ofs_.flush();
+		}
+	};
+
+	// XbhƂɋL^𗭂߁Ȃ傫ɂȂWriterɃ`NƂēn
+	class ChunkBuffer {
+	private:
+		Writer* writer_;
+		std::vector<uint8_t> bytes_;
+		uint32_t record_number_;
+
+	public:
+		explicit ChunkBuffer(Writer* writer) :writer_(writer), record_number_(0) {
+			this->bytes_.reserve(CHUNK_BYTE_SIZE * 2);
+		}
+
+		~ChunkBuffer() {
+			this->flush();
+		}
+
+		// 1ǖʕ̋L^ǉ
+		void addRecord(const RecordHeader& header, const int32_t* actions, const float* policy, const uint8_t* state) {
+			const size_t offset = this->bytes_.size();
+			this->bytes_.resize(offset + recordByteSize(header));
+			uint8_t* p = this->bytes_.data() + offset;
+			std::memcpy(p, &header, sizeof(header));
+			p += sizeof(header);
+			std::memcpy(p, actions, header.action_number * sizeof(int32_t));
+			p += header.action_number * sizeof(int32_t);
+			std::memcpy(p, policy, header.policy_size * sizeof(float));
+			p += header.policy_size * sizeof(float);
+			std::memcpy(p, state, header.state_size);
+			this->record_number_++;
+			if (this->bytes_.size() >= CHUNK_BYTE_SIZE)this->flush();
+		}
+
+		// ܂ĂL^o
+		void flush() {
+			if (this->record_number_ == 0)return;
+			this->writer_->appendChunk(this->bytes_, this->record_number_);
+			this->bytes_.clear();
+			this->record_number_ = 0;
+		}
+	};
+
+	// L^1At@C̃f[^w܂ܓǂނ߂̃r[
+	struct Record {
+		RecordHeader header;
+		const int32_t* actions;
+		const float* policy;
+		const uint8_t* state;
+	};
+
+	// wKf[^̃t@C}bvēǂށB}bvłȂł̓t@CŜǂݍ
+	class Reader {
+	private:
+		const uint8_t* data_;
+		size_t size_;
+		void* mapped_;
+		std::vector<uint8_t> buffer_;
+		FileHeader header_;
+
+	public:
+		// RXgN^O𓊂ƃfXgN^͌Ă΂Ȃ̂ŁA؂I܂łmmap̈[JϐŎ
+		explicit Reader(const std::string& path) :data_(nullptr), size_(0), mapped_(nullptr) {
+			void* mapped = nullptr;
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+#ifndef _WIN32
+			const int fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0)throw std::string("cannot open ") + path;
+			struct stat st;
+			if (fstat(fd, &st) == 0 && st.st_size > 0) {
+				void* result = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+				if (result != MAP_FAILED) {
+					mapped = result;
+					data = static_cast<const uint8_t*>(result);
+					size = st.st_size;
+				}
+			}
+			close(fd);
+#endif
+			if (data == nullptr) {
+				std::ifstream ifs(path, std::ios::binary);
+				if (!ifs)throw std::string("cannot open ") + path;
+				this->buffer_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+				data = this->buffer_.data();
+				size = this->buffer_.size();
+			}
+			// ꂽt@CȂAmmap̈ĂO𓊂
+			const auto broken = [&]() {
+#ifndef _WIN32
+				if (mapped != nullptr)
+					munmap(mapped, size);
+#endif
+				return std::string("broken self-play data ") + path;
+			};
+			if (size < sizeof(FileHeader))throw broken();
+			std::memcpy(&this->header_, data, sizeof(FileHeader));
+			if (std::memcmp(this->header_.magic, FILE_MAGIC, sizeof(this->header_.magic)) != 0)
+				throw broken();
+			this->mapped_ = mapped;
+			this->data_ = data;
+			this->size_ = size;
+		}
+
+		Reader(const Reader&) = delete;
+		Reader& operator=(const Reader&) = delete;
+
+		~Reader() {
+#ifndef _WIN32
+			if (this->mapped_ != nullptr)
+				munmap(this->mapped_, this->size_);
+#endif
+		}
+
+		// ǂ̃Q[̃f[^Ԃ
+		uint32_t gameId()const {
+			return this->header_.game_id;
+		}
+
+		// SĂ̋L^擪珇callbackɓnAL^̐ԂB̃`N͓ǂ܂Ȃ
+		int64_t forEachRecord(const std::function<void(const Record&)>& callback)const {
+			int64_t record_number = 0;
+			size_t offset = sizeof(FileHeader);
+			while (offset + sizeof(ChunkHeader) <= this->size_) {
+				ChunkHeader chunk;
+				std::memcpy(&chunk, this->data_ + offset, sizeof(chunk));
+				offset += sizeof(chunk);
+				if (chunk.magic != CHUNK_MAGIC || offset + chunk.byte_size > this->size_)break;
+				const uint8_t* p = this->data_ + offset;
+				for (uint32_t i = 0; i < chunk.record_number; i++) {
+					Record record;
+					std::memcpy(&record.header, p, sizeof(record.header));
+					record.actions = reinterpret_cast<const int32_t*>(p + sizeof(RecordHeader));
+					record.policy = reinterpret_cast<const float*>(record.actions + record.header.action_number);
+					record.state = reinterpret_cast<const uint8_t*>(record.policy + record.header.policy_size);
+					callback(record);
+					p += recordByteSize(record.header);
+					record_number++;
+				}
+				offset += chunk.byte_size;
+			}
+			return record_number;
+		}
+	};
+
+	constexpr const uint32_t GAME_ID = 0; // lQ[̃f[^
+
+	// 1ǂvCAǖʂƂ̔ՖʁAI񂾍sAMCTS̎s񐔂̕zAŏIXRAL^
+	void playSelfPlayGame(const uint32_t game_index, const State& initial_state, const int playout_number, Xoshiro128& rng, ChunkBuffer* buffer) {
+		struct Position {
+			State state;
+			int32_t action;
+			float policy[State::MAX_ACTION_NUMBER];
+		};
+		std::vector<Position> positions;
+		auto state = initial_state;
+		while (!state.isDone()) {
+			Position position{ state, -1, {} };
+			montecarlo::Tree tree = montecarlo::Tree(state, rng());
+			tree.expandRoot();
+			for (int i = 0; i < playout_number; i++) {
+				tree.evaluate();
+			}
+			const int begin = tree.child_begin_[0];
+			const int end = begin + tree.child_size_[0];
+			double total = 0;
+			for (int i = begin; i < end; i++) {
+				total += tree.n_[i];
+			}
+			for (int i = begin; i < end; i++) {
+				position.policy[tree.actions_[i]] = total > 0 ? (float)(tree.n_[i] / total) : 0.f;
+			}
+			position.action = tree.bestAction();
+			positions.emplace_back(position);
+			state.advance(position.action);
+		}
+		std::vector<uint8_t> encoded;
+		for (int ply = 0; ply < (int)positions.size(); ply++) {
+			const auto& position = positions[ply];
+			encoded.resize(position.state.encodedSize());
+			position.state.encode(encoded.data());
+			RecordHeader header{};
+			header.game_index = game_index;
+			header.state_size = (uint32_t)encoded.size();
+			header.ply = (uint16_t)ply;
+			header.policy_size = State::MAX_ACTION_NUMBER;
+			header.action_number = 1;
+			header.outcome = (float)state.game_score_;
+			buffer->addRecord(header, &position.action, position.policy, encoded.data());
+		}
+	}
+
+	// Xbh1̎ȑΐBSXbhŋLԍȂgame_numberǂ܂ŃvC
+	void selfPlayWorker(Writer* writer, std::atomic<uint32_t>* next_game_index, const uint32_t game_number, const int playout_number, const int h, const int w, const int end_turn, const uint64_t seed) {
+		Xoshiro128 rng(seed);
+		ChunkBuffer buffer(writer);
+		for (uint32_t game_index = (*next_game_index)++; game_index < game_number; game_index = (*next_game_index)++) {
+			playSelfPlayGame(game_index, State(h, w, end_turn, (int)rng()), playout_number, rng, &buffer);
+		}
+	}
+
+	// 1肠̃vCAEgƃXbhw肵āA_ȔՖʂgame_numberǂvCAwKf[^path̃t@CɒǋL
+	void runSelfPlay(const std::string& path, const uint32_t game_number, const int playout_number, const int thread_number, const int h, const int w, const int end_turn) {
+		Writer writer(path, GAME_ID);
+		std::atomic<uint32_t> next_game_index(0);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < thread_number; t++) {
+			threads.emplace_back(selfPlayWorker, &writer, &next_game_index, game_number, playout_number, h, w, end_turn, (uint64_t)mt());
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+}
+using selfplay::runSelfPlay;
+
+// Ht@C̓ǂݏ
+// 傫ȖH̃x`}[N𓯂ŌJԂ悤AHt@CɌŒ肵Aǂݍ݂mmapōs
+namespace mazefile {
+	constexpr const char MAGIC[8] = "MAZE001";
+	constexpr const int MAX_CHARACTER_NUMBER = 2; // lQ[ƓlQ[œ`g
+	constexpr const int CHARACTER_NUMBER = 1; // ̃Q[̃LN^[
+	constexpr const char* EXTENSION = ".maze";
+
+	// t@C̐擪ɒuwb_Bĕǂh*woCgA|Cgh*woCgׂ
+	struct Header {
+		char magic[8];
+		int32_t h;
+		int32_t w;
+		int32_t end_turn;
+		int32_t character_number;
+		int32_t characters[MAX_CHARACTER_NUMBER][2]; // eLN^[̏(y,x)
+	};
+
+	// Hpath̃t@Cɏo
+	void write(const std::string& path, const MazeBoard& board) {
+		Header header = {};
+		std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+		header.h = board.h_;
+		header.w = board.w_;
+		header.end_turn = board.end_turn_;
+		header.character_number = CHARACTER_NUMBER;
+		header.characters[0][0] = board.start_y_;
+		header.characters[0][1] = board.start_x_;
+		std::ofstream ofs(path, std::ios::binary);
+		if (!ofs)throw std::string("cannot open ") + path;
+		const size_t area = (size_t)board.h_ * board.w_;
+		ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		ofs.write(reinterpret_cast<const char*>(board.walls_), area);
+		ofs.write(reinterpret_cast<const char*>(board.points_), area);
+		if (!ofs)throw std::string("cannot write ") + path;
+	}
+
+	// path̖Ht@CǂݍށBǂƏ|Cgmmap̈̂܂܎QƂ
+	std::shared_ptr<const MazeBoard> load(const std::string& path) {
+		auto board = std::make_shared<MazeBoard>();
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+#ifndef _WIN32
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)throw std::string("cannot open ") + path;
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size > 0) {
+			const size_t mapped_size = st.st_size;
+			void* mapped = mmap(nullptr, mapped_size, PROT_READ, MAP_SHARED, fd, 0);
+			if (mapped != MAP_FAILED) {
+				board->mapping_ = std::shared_ptr<const void>(mapped, [mapped_size](const void* p) { munmap(const_cast<void*>(p), mapped_size); });
+				data = static_cast<const uint8_t*>(mapped);
+				size = mapped_size;
+			}
+		}
+		close(fd);
+#endif
+		if (data == nullptr) {
+			std::ifstream ifs(path, std::ios::binary);
+			if (!ifs)throw std::string("cannot open ") + path;
+			board->buffer_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+			data = board->buffer_.data();
+			size = board->buffer_.size();
+		}
+
+		Header header;
+		if (size < sizeof(header))throw std::string("broken maze file ") + path;
+		std::memcpy(&header, data, sizeof(header));
+		if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0
+			|| header.h <= 0 || header.w <= 0 || header.end_turn < 0
+			|| size != sizeof(header) + 2 * (size_t)header.h * header.w)
+			throw std::string("broken maze file ") + path;
+		if (header.character_number != CHARACTER_NUMBER)
+			throw std::string("maze file for another game ") + path;
+		board->h_ = header.h;
+		board->w_ = header.w;
+		board->end_turn_ = header.end_turn;
+		board->start_y_ = header.characters[0][0];
+		board->start_x_ = header.characters[0][1];
+		board->walls_ = data + sizeof(header);
+		board->points_ = board->walls_ + (size_t)header.h * header.w;
+		if (board->start_y_ < 0 || board->start_y_ >= board->h_ || board->start_x_ < 0 || board->start_x_ >= board->w_
+			|| board->walls_[board->start_y_ * board->w_ + board->start_x_])
+			throw std::string("broken maze file ") + path;
+		return board;
+	}
+
+	// directoryɂHt@CAt@CɑSēǂݍ
+	std::vector<std::shared_ptr<const MazeBoard>> loadDirectory(const std::string& directory) {
+		std::vector<std::string> paths;
+		for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+			if (entry.is_regular_file() && entry.path().extension() == EXTENSION) {
+				paths.emplace_back(entry.path().string());
+			}
+		}
+		std::sort(paths.begin(), paths.end());
+		std::vector<std::shared_ptr<const MazeBoard>> boards;
+		for (const auto& path : paths) {
+			boards.emplace_back(load(path));
+		}
+		return boards;
+	}
+
+	// V[h0~number-1Őh*w̖HAdirectoryɖHt@CƂďo
+	void generateDirectory(const std::string& directory, const int number, const int h, const int w, const int end_turn) {
+		std::filesystem::create_directories(directory);
+		for (int seed = 0; seed < number; seed++) {
+			std::string name = std::to_string(seed);
+			name = std::string(name.size() < 6 ? 6 - name.size() : 0, '0') + name;
+			write((std::filesystem::path(directory) / (name + EXTENSION)).string(), *State(h, w, end_turn, seed).board());
+		}
+	}
+}
+
+#ifndef _WIN32
+// ̃vZXő΋ǂ𕪒S
+// R[fBl[^[UnixhC\Pbgő҂󂯁AڑĂ[J[1ǂdnČʂ󂯎
+// ʂ1ǂƂɒǋL̂ŁAR[fBl[^[⃏[J[~܂ĂI΋ǂ͎Ȃ
+// ḾuREADYvuGAME  ݒ V[hvuRESULT  ʁvuDONEv1s̃eLXgōs
+namespace farm {
+	constexpr const int POLL_INTERVAL = 100; // ҂󂯂̊Ԋu(ms)
+	constexpr const int CONNECT_RETRY_NUMBER = 100; // [J[R[fBl[^[̋N҂
+
+	// 1Ǖ̎dBconfigurationԖڂ̐ݒŁAseedՖʂ1ǃvC
+	struct Task {
+		int game_index;
+		int configuration;
+		uint32_t seed;
+	};
+
+	// game_indexǖڂ̎dԂBSĂ̐ݒ肪V[hɃvC悤U
+	Task taskOf(const int game_index, const int configuration_number) {
+		return Task{ game_index, game_index % configuration_number, (uint32_t)(game_index / configuration_number) };
+	}
+
+	// 1sBȂfalseԂ
+	bool sendLine(const int fd, const std::string& line) {
+		const std::string data = line + "\n";
+		size_t sent = 0;
+		while (sent < data.size()) {
+			const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+			if (n < 0 && errno == EINTR)
+				continue;
+			if (n <= 0)
+				return false;
+			sent += n;
+		}
+		return true;
+	}
+
+	// Mf[^bufferɒǋLBؒfꂽfalseԂ
+	bool receive(const int fd, std::string* buffer) {
+		char data[4096];
+		const ssize_t n = recv(fd, data, sizeof(data), 0);
+		if (n < 0 && errno == EINTR)
+			return true;
+		if (n <= 0)
+			return false;
+		buffer->append(data, n);
+		return true;
+	}
+
+	// buffer1soB܂1sĂȂfalseԂ
+	bool popLine(std::string* buffer, std::string* line) {
+		const size_t position = buffer->find('\n');
+		if (position == std::string::npos)
+			return false;
+		*line = buffer->substr(0, position);
+		buffer->erase(0, position + 1);
+		return true;
+	}
+
+	// pathUnixhC\Pbg̃AhXԂ
+	sockaddr_un socketAddress(const std::string& path) {
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		if (path.size() >= sizeof(address.sun_path))
+			throw std::string("socket path too long ") + path;
+		std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+		return address;
+	}
+
+	// [J[ɎdzAʂt@CɒǋLR[fBl[^[
+	// ʃt@Ću ݒ V[h ʁv̍s̕тŁAʂ̐擪̓XRAɂ
+	// NɌʃt@Cǂ݁AIĂǂ͔zȂ
+	class Coordinator {
+	private:
+		struct Worker {
+			int fd;
+			std::string buffer;
+			bool is_waiting; // d҂Ă邩
+			int game_index; // S̋ǁBȂ-1
+		};
+
+		std::string socket_path_;
+		int listen_fd_;
+		int game_number_;
+		int configuration_number_;
+		std::ofstream result_stream_;
+		std::vector<uint8_t> is_done_;
+		int done_number_;
+		std::deque<int> pending_; // ܂NɂnĂȂ
+		std::vector<Worker> workers_;
+		std::vector<double> score_sums_; // ݒ育Ƃ̃XRA̘a
+		std::vector<int> score_counts_; // ݒ育Ƃ̏Iǐ
+
+		// ʂ1sǂݍŏWvAWvłԂBꂽsdǂ͖
+		bool load(const std::string& line) {
+			std::istringstream iss(line);
+			int game_index, configuration;
+			uint32_t seed;
+			double score;
+			if (!(iss >> game_index >> configuration >> seed >> score))
+				return false;
+			if (game_index < 0 || game_index >= this->game_number_ || this->is_done_[game_index])
+				return false;
+			const Task task = taskOf(game_index, this->configuration_number_);
+			if (task.configuration != configuration || task.seed != seed)
+				return false;
+			this->is_done_[game_index] = 1;
+			++this->done_number_;
+			this->score_sums_[configuration] += score;
+			++this->score_counts_[configuration];
+			return true;
+		}
+
+		// ҂Ă郏[J[Ɏ̋ǂnBSďIĂΏI`
+		bool assign(Worker* worker) {
+			if (this->pending_.empty()) {
+				if (!this->isFinished())
+					return true; // ̃[J[S̋ǂ߂Ă邩Ȃ̂ő҂
+				worker->is_waiting = false;
+				return sendLine(worker->fd, "DONE");
+			}
+			const Task task = taskOf(this->pending_.front(), this->configuration_number_);
+			this->pending_.pop_front();
+			worker->is_waiting = false;
+			worker->game_index = task.game_index;
+			return sendLine(worker->fd, "GAME " + std::to_string(task.game_index) + " " + std::to_string(task.configuration) + " " + std::to_string(task.seed));
+		}
+
+		// [J[󂯎1sBڑ؂ׂȂfalseԂ
+		bool handle(Worker* worker, const std::string& line) {
+			std::istringstream iss(line);
+			std::string command;
+			iss >> command;
+			if (command == "READY") {
+				worker->is_waiting = true;
+				return this->assign(worker);
+			}
+			if (command != "RESULT")
+				return false;
+			int game_index;
+			if (!(iss >> game_index) || game_index < 0 || game_index >= this->game_number_)
+				return false;
+			if (game_index == worker->game_index) {
+				worker->game_index = -1;
+				worker->is_waiting = true;
+			}
+			else if (!this->is_done_[game_index])
+				return false; // nĂȂǂ̌
+			// z蒼ǂ𑼂̃[J[ɏIĂꍇ́Aʂ̂ĂĐڑ͂̂܂܎g
+			if (!this->is_done_[game_index]) {
+				std::string result;
+				std::getline(iss >> std::ws, result);
+				const Task task = taskOf(game_index, this->configuration_number_);
+				const std::string record = std::to_string(task.game_index) + " " + std::to_string(task.configuration) + " " + std::to_string(task.seed) + " " + result;
+				if (!this->load(record))
+					return false;
+				this->result_stream_ << record << std::endl;
+			}
+			return worker->is_waiting ? this->assign(worker) : true;
+		}
+
+		// ҂sɂڑSĎ󂯕t
+		void acceptAll() {
+			int fd;
+			while ((fd = accept(this->listen_fd_, nullptr, nullptr)) >= 0) {
+				this->workers_.emplace_back(Worker{ fd, "", false, -1 });
+			}
+		}
+
+		// ڑAS̋ǂΔz蒼
+		void drop(Worker* worker) {
+			close(worker->fd);
+			worker->fd = -1;
+			if (worker->game_index >= 0 && !this->is_done_[worker->game_index])
+				this->pending_.push_front(worker->game_index);
+		}
+
+	public:
+		Coordinator(const std::string& socket_path, const std::string& result_path, const int game_number, const int configuration_number) :
+			socket_path_(socket_path),
+			listen_fd_(-1),
+			game_number_(game_number),
+			configuration_number_(configuration_number),
+			is_done_(game_number, 0),
+			done_number_(0),
+			score_sums_(configuration_number, 0),
+			score_counts_(configuration_number, 0)
+		{
+			bool ends_with_newline = true;
+			off_t complete_size = 0; // sŏIĂs܂ł̃oCg
+			{
+				std::ifstream ifs(result_path);
+				std::string line;
+				while (std::getline(ifs, line)) {
+					if (ifs.eof()) {
+						ends_with_newline = false;
+						break;
+					}
+					this->load(line);
+					complete_size += line.size() + 1;
+				}
+			}
+			if (!ends_with_newline && truncate(result_path.c_str(), complete_size) != 0) // Ŏ~܂Ō̍ŝ͎Ă
+				throw std::string("cannot truncate ") + result_path;
+			this->result_stream_.open(result_path, std::ios::app);
+			if (!this->result_stream_)
+				throw std::string("cannot open ") + result_path;
+			for (int game_index = 0; game_index < game_number; game_index++) {
+				if (!this->is_done_[game_index])
+					this->pending_.emplace_back(game_index);
+			}
+
+			const auto address = socketAddress(socket_path);
+			unlink(socket_path.c_str());
+			this->listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (this->listen_fd_ < 0
+				|| bind(this->listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+				|| listen(this->listen_fd_, SOMAXCONN) != 0
+				|| fcntl(this->listen_fd_, F_SETFL, O_NONBLOCK) != 0) // ڑėĂ1̑҂󂯂ł܂Ƃ߂Ď󂯕t悤ɂ
+				throw std::string("cannot listen on ") + socket_path;
+		}
+
+		Coordinator(const Coordinator&) = delete;
+		Coordinator& operator=(const Coordinator&) = delete;
+
+		~Coordinator() {
+			this->shutdown();
+		}
+
+		// SĂ̋ǂI肷
+		bool isFinished()const {
+			return this->done_number_ == this->game_number_;
+		}
+
+		// IǐԂ
+		int doneNumber()const {
+			return this->done_number_;
+		}
+
+		// őtimeout(ms)҂āAڑ̎󂯕tƌʂ̎󂯎
+		void step(const int timeout) {
+			std::vector<pollfd> fds = { pollfd{ this->listen_fd_, POLLIN, 0 } };
+			for (const auto& worker : this->workers_) {
+				fds.emplace_back(pollfd{ worker.fd, POLLIN, 0 });
+			}
+			if (poll(fds.data(), fds.size(), timeout) < 0)
+				return;
+			for (int i = 0; i < (int)this->workers_.size(); i++) {
+				auto& worker = this->workers_[i];
+				if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)))
+					continue;
+				bool is_alive = receive(worker.fd, &worker.buffer);
+				std::string line;
+				while (is_alive && popLine(&worker.buffer, &line)) {
+					is_alive = this->handle(&worker, line);
+				}
+				if (!is_alive)
+					this->drop(&worker);
+			}
+			this->workers_.erase(std::remove_if(this->workers_.begin(), this->workers_.end(), [](const Worker& worker) { return worker.fd < 0; }), this->workers_.end());
+			if (fds[0].revents & POLLIN)
+				this->acceptAll();
+			// z蒼ɂȂǂ҂Ă郏[J[ɓn
+			for (auto& worker : this->workers_) {
+				if (worker.is_waiting && !this->assign(&worker))
+					this->drop(&worker);
+			}
+			this->workers_.erase(std::remove_if(this->workers_.begin(), this->workers_.end(), [](const Worker& worker) { return worker.fd < 0; }), this->workers_.end());
+		}
+
+		// ҂󂯂߁AڑƐڑ҂̃[J[SĂɏI`ă\Pbg
+		// IɃ[J[̏I҂Ƃ́AɂĂő҂郏[J[cȂ悤ɂ
+		void shutdown() {
+			if (this->listen_fd_ < 0)
+				return;
+			this->acceptAll();
+			for (auto& worker : this->workers_) {
+				if (worker.fd >= 0)
+					sendLine(worker.fd, "DONE");
+			}
+			this->releaseSockets();
+			unlink(this->socket_path_.c_str());
+		}
+
+		// \PbgSĕBforkqvZXł͈p\Pbgŕ
+		void releaseSockets() {
+			for (auto& worker : this->workers_) {
+				if (worker.fd >= 0)
+					close(worker.fd);
+				worker.fd = -1;
+			}
+			this->workers_.clear();
+			if (this->listen_fd_ >= 0)
+				close(this->listen_fd_);
+			this->listen_fd_ = -1;
+		}
+
+		// ݒ育Ƃ̕σXRA𕶎ɂ
+		std::string summary()const {
+			std::stringstream ss;
+			for (int configuration = 0; configuration < this->configuration_number_; configuration++) {
+				const int count = this->score_counts_[configuration];
+				ss << "Score of configuration " << configuration << ":\t" << (count > 0 ? this->score_sums_[configuration] / count : 0.) << " (" << count << " games)\n";
+			}
+			return ss.str();
+		}
+	};
+
+	// R[fBl[^[ɐڑAnꂽdplay_gameŃvCČʂԂBI`邩ؒfꂽ߂
+	void runWorker(const std::string& socket_path, const std::function<std::string(const Task&)>& play_game) {
+		const auto address = socketAddress(socket_path);
+		int fd = -1;
+		for (int retry = 0;; retry++) {
+			fd = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0)
+				break;
+			if (fd >= 0)
+				close(fd);
+			if (retry >= CONNECT_RETRY_NUMBER)
+				throw std::string("cannot connect to ") + socket_path;
+			std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL));
+		}
+		std::string buffer, line;
+		if (sendLine(fd, "READY")) {
+			while (true) {
+				while (!popLine(&buffer, &line)) {
+					if (!receive(fd, &buffer)) {
+						close(fd);
+						return;
+					}
+				}
+				std::istringstream iss(line);
+				std::string command;
+				Task task;
+				iss >> command;
+				if (command != "GAME" || !(iss >> task.game_index >> task.configuration >> task.seed))
+					break;
+				if (!sendLine(fd, "RESULT " + std::to_string(task.game_index) + " " + play_game(task)))
+					break;
+			}
+		}
+		close(fd);
+	}
+}
+#endif
+
 #include<iostream>
 #include<functional>
 using AIFunction = std::function<Action(const State&)>;
 using StringAIPair = std::pair<std::string, AIFunction>;
 
 // Q[1vCăQ[󋵂\
-void playGame(const StringAIPair& ai,const int h,const int w,const int end_turn,const int seed) {
+// prints_boardfalseȂ疈^[̔Ֆʂ̕񉻂ȂAŌ̔Ֆʂ\
+void playGame(const StringAIPair& ai,const int h,const int w,const int end_turn,const int seed,const bool prints_board = true) {
 	using std::cout; using std::endl;
 
 	auto state = State(h, w,end_turn, seed);
 	state.evaluateScore();
-	std::cout << state.toString() << std::endl;
+	if (prints_board)std::cout << state.toString() << std::endl;
 	while (!state.isDone()) {
 		state.advance(ai.second(state));
 		state.evaluateScore();
-		std::cout << state.toString() << std::endl;
+		if (prints_board)std::cout << state.toString() << std::endl;
+	}
+	if (!prints_board)std::cout << state.toString() << std::endl;
+}
+
+// BՖʂ̑傫ƃV[hAs̗ƎvlԂAՖʂreplayō蒼
+struct GameRecord {
+	int h = 0;
+	int w = 0;
+	int end_turn = 0;
+	int seed = 0;
+	Actions actions;
+	std::vector<int64_t> microseconds; // sƂ̎vl(s)
+
+	// u  I^[ V[h s s... vl...v1sŏo
+	void write(std::ostream& os)const {
+		os << this->h << ' ' << this->w << ' ' << this->end_turn << ' ' << this->seed << ' ' << this->actions.size();
+		for (const auto action : this->actions)os << ' ' << action;
+		for (const auto microsecond : this->microseconds)os << ' ' << microsecond;
+		os << '\n';
+	}
+
+	// writeŏ1sǂݍށBǂ߂ȂfalseԂ
+	bool read(std::istream& is) {
+		size_t action_number;
+		if (!(is >> this->h >> this->w >> this->end_turn >> this->seed >> action_number))return false;
+		this->actions.resize(action_number);
+		this->microseconds.resize(action_number);
+		for (auto& action : this->actions)is >> action;
+		for (auto& microsecond : this->microseconds)is >> microsecond;
+		return (bool)is;
+	}
+
+	// turnڂ܂Ői߂Ֆʂ蒼
+	State replay(const int turn)const {
+		auto state = State(this->h, this->w, this->end_turn, this->seed);
+		for (int i = 0; i < turn && i < (int)this->actions.size(); i++) {
+			state.advance(this->actions[i]);
+		}
+		state.evaluateScore();
+		return state;
+	}
+};
+
+// Q[1vCĊԂBՖʂ̕\͂Ȃ
+GameRecord recordGame(const StringAIPair& ai, const int h, const int w, const int end_turn, const int seed) {
+	GameRecord record;
+	record.h = h;
+	record.w = w;
+	record.end_turn = end_turn;
+	record.seed = seed;
+	auto state = State(h, w, end_turn, seed);
+	while (!state.isDone()) {
+		const auto start_time = std::chrono::high_resolution_clock::now();
+		const Action action = ai.second(state);
+		const auto diff = std::chrono::high_resolution_clock::now() - start_time;
+		record.actions.emplace_back(action);
+		record.microseconds.emplace_back(std::chrono::duration_cast<std::chrono::microseconds>(diff).count());
+		state.advance(action);
+	}
+	return record;
+}
+
+// t@Cgame_indexǖڂturnڂ܂ōČĕ\
+void replayGame(const std::string& path, const int game_index, const int turn) {
+	using std::cout; using std::endl;
+	std::ifstream ifs(path);
+	GameRecord record;
+	for (int i = 0; i <= game_index; i++) {
+		if (!record.read(ifs))throw std::string("no game record ") + std::to_string(game_index) + " in " + path;
+	}
+	cout << "turn " << turn << " / " << record.actions.size() << endl;
+	if (turn > 0 && turn <= (int)record.actions.size())
+		cout << "action " << record.actions[turn - 1] << " (" << record.microseconds[turn - 1] << "us)" << endl;
+	cout << record.replay(turn).toString() << endl;
+}
+
+#ifndef _WIN32
+// configurations[task.configuration]AIŁAtask.seedh*w̖H1vCAuXRA v1sԂ
+std::string playFarmGame(const std::vector<StringAIPair>& configurations, const farm::Task& task, const int h, const int w, const int end_turn) {
+	mt.seed(task.seed);
+	const auto record = recordGame(configurations[task.configuration], h, w, end_turn, (int)task.seed);
+	std::stringstream ss;
+	ss << record.replay((int)record.actions.size()).game_score_ << ' ';
+	record.write(ss);
+	std::string result = ss.str();
+	result.pop_back(); // writets
+	return result;
+}
+
+// R[fBl[^[Ƃđ҂󂯁AʂɋN[J[game_numberǂ𕪒SČʂresult_pathɒǋL
+void runFarmCoordinator(const std::string& socket_path, const std::string& result_path, const int game_number, const int configuration_number) {
+	farm::Coordinator coordinator(socket_path, result_path, game_number, configuration_number);
+	while (!coordinator.isFinished()) {
+		coordinator.step(farm::POLL_INTERVAL);
+	}
+	coordinator.shutdown();
+	std::cout << coordinator.summary();
+}
+
+// [J[ƂăR[fBl[^[ɐڑAnꂽԍAIh*w̖HvC
+void runFarmWorker(const std::string& socket_path, const std::vector<StringAIPair>& configurations, const int h, const int w, const int end_turn) {
+	farm::runWorker(socket_path, [&](const farm::Task& task) { return playFarmGame(configurations, task, h, w, end_turn); });
+}
+
+// R[fBl[^[worker_number̃[J[vZXNAconfigurations̊eAIh*w̖Hgame_number񕪒SăvC
+// rŏI[J[͋NBʃt@CcĂ΁AIĂȂǂĊJ
+void runFarm(const std::string& socket_path, const std::string& result_path, const int game_number, const std::vector<StringAIPair>& configurations, const int worker_number, const int h, const int w, const int end_turn) {
+	farm::Coordinator coordinator(socket_path, result_path, game_number, (int)configurations.size());
+	std::vector<pid_t> pids;
+	const auto spawn = [&]() {
+		const pid_t pid = fork();
+		if (pid < 0)
+			throw std::string("cannot fork worker");
+		if (pid == 0) {
+			coordinator.releaseSockets();
+			try {
+				runFarmWorker(socket_path, configurations, h, w, end_turn);
+			}
+			catch (const std::string& error) {
+				std::cerr << error << std::endl;
+				_exit(1);
+			}
+			_exit(0);
+		}
+		pids.emplace_back(pid);
+	};
+	for (int i = 0; i < worker_number && !coordinator.isFinished(); i++) {
+		spawn();
 	}
+	while (!coordinator.isFinished()) {
+		coordinator.step(farm::POLL_INTERVAL);
+		pid_t pid;
+		while ((pid = waitpid(-1, nullptr, WNOHANG)) > 0) {
+			pids.erase(std::remove(pids.begin(), pids.end(), pid), pids.end());
+			if (!coordinator.isFinished()) {
+				std::cerr << "worker " << pid << " exited, restarting" << std::endl;
+				spawn();
+			}
+		}
+	}
+	// SďÎŁAڑ҂̃[J[ɂI`A܂ڑĂȂ[J[͎~߂
+	coordinator.shutdown();
+	for (const auto pid : pids) {
+		kill(pid, SIGTERM);
+		waitpid(pid, nullptr, 0);
+	}
+	std::cout << coordinator.summary();
 }
+#endif
+
+// m䌟(SPRT)ŁA1sƂ̓_̕ςmean0mean1𔻒肷NX
+// _͐KzŋߎAU͊ϑl琄肷
+class SequentialTest {
+private:
+	double mean0_; // A̕
+	double mean1_; // Η̕
+	double lower_bound_; // ΐޓx䂪Ȃ
+	double upper_bound_; // ΐޓx䂪Η̑
+	int n_;
+	double sum_;
+	double square_sum_;
+
+	// SȂǂŕU0ɂȂƔłȂ߁A̕ς1񂸂ϑ̂ƂĕU𐄒肷
+	double regularizedVariance()const {
+		const double n = this->n_ + 2;
+		const double mean = (this->sum_ + this->mean0_ + this->mean1_) / n;
+		return std::max(0.0, (this->square_sum_ + this->mean0_ * this->mean0_ + this->mean1_ * this->mean1_) / n - mean * mean);
+	}
+
+public:
+	enum Result {
+		CONTINUE,
+		ACCEPT_H0,
+		ACCEPT_H1,
+	};
+
+	// AƑΗ̕ρA1̌藦alphaA2̌藦betaw肵ăCX^X
+	SequentialTest(const double mean0, const double mean1, const double alpha, const double beta) :
+		mean0_(mean0),
+		mean1_(mean1),
+		lower_bound_(log(beta / (1 - alpha))),
+		upper_bound_(log((1 - beta) / alpha)),
+		n_(0),
+		sum_(0),
+		square_sum_(0)
+	{
+
+	}
+
+	// 1s̓_ǉ
+	void add(const double score) {
+		this->n_++;
+		this->sum_ += score;
+		this->square_sum_ += score * score;
+	}
+
+	// s񐔂Ԃ
+	int size()const {
+		return this->n_;
+	}
+
+	// _̕ςԂ
+	double mean()const {
+		return this->n_ == 0 ? 0 : this->sum_ / this->n_;
+	}
+
+	// _̕ς̐MԂ̔ԂBz͐Kz̕ʓ_ŁA1.96Ȃ95%M
+	double margin(const double z = 1.96)const {
+		if (this->n_ == 0)return 0;
+		return z * sqrt(this->regularizedVariance() / this->n_);
+	}
+
+	// ΐޓxԂB2sł0
+	double llr()const {
+		const double variance = this->regularizedVariance();
+		if (this->n_ < 2 || variance <= 0)return 0;
+		return (this->mean1_ - this->mean0_) * (2 * this->sum_ - this->n_ * (this->mean0_ + this->mean1_)) / (2 * variance);
+	}
+
+	// _̌茋ʂԂ
+	Result result()const {
+		const double llr = this->llr();
+		if (llr <= this->lower_bound_)return ACCEPT_H0;
+		if (llr >= this->upper_bound_)return ACCEPT_H1;
+		return CONTINUE;
+	}
+
+	double lowerBound()const {
+		return this->lower_bound_;
+	}
+
+	double upperBound()const {
+		return this->upper_bound_;
+	}
+};
 
 // Q[game_numbervCăXRAς\
 void testAiScore(const StringAIPair& ai, const int game_number, const int h, const int w, const int end_turn) {
@@ -411,6 +2081,53 @@ void testAiScore(const StringAIPair& ai, const int game_number, const int h, con
 	score_mean /= (double)game_number;
 	cout << "Score of " << ai.first << ":\t" << score_mean << endl;
 }
+
+// Ht@Cǂݍ񂾊eHAI1񂸂vCAXRA̕ς\
+void testAiScore(const StringAIPair& ai, const std::vector<std::shared_ptr<const MazeBoard>>& boards) {
+	using std::cout; using std::endl;
+	double score_mean = 0;
+	for (int i = 0; i < (int)boards.size(); i++) {
+		auto state = State(boards[i]);
+
+		while (!state.isDone()) {
+			state.advance(ai.second(state));
+		}
+		score_mean += state.game_score_;
+
+		cout << "i " << i << " score " << score_mean / (i + 1) << endl;
+	}
+	score_mean /= (double)boards.size();
+	cout << "Score of " << ai.first << ":\t" << score_mean << endl;
+}
+
+// Ֆʂ2AIőmax_game_numbervCAai0ai1̃XRA̕ς0(A)delta(Η)
+// SPRTŗLӂɂȂ_őł؂āAXRAƂ95%MԂ\
+void testAiScoreDifferenceWithSprt(const StringAIPair& ai0, const StringAIPair& ai1, const int max_game_number, const int h, const int w, const int end_turn, const double delta, const double alpha = 0.05, const double beta = 0.05) {
+	using std::cout; using std::endl;
+	std::mt19937 mt_for_construct(0);
+	auto test = SequentialTest(0, delta, alpha, beta);
+	for (int i = 0; i < max_game_number; i++) {
+		const auto initial_state = State(h, w, end_turn, mt_for_construct());
+		ScoreType scores[2];
+		for (int j = 0; j < 2; j++) {
+			const auto& ai = j == 0 ? ai0 : ai1;
+			auto state = initial_state;
+			while (!state.isDone()) {
+				state.advance(ai.second(state));
+			}
+			scores[j] = state.game_score_;
+		}
+		test.add((double)(scores[0] - scores[1]));
+
+		cout << "i " << i << " diff " << test.mean() << " +- " << test.margin()
+			<< " llr " << test.llr() << " [" << test.lowerBound() << ", " << test.upperBound() << "]" << endl;
+		if (test.result() != SequentialTest::CONTINUE)break;
+	}
+	const auto result = test.result();
+	cout << "Score difference of " << ai0.first << " to " << ai1.first << ":\t" << test.mean() << " +- " << test.margin()
+		<< "\t" << (result == SequentialTest::ACCEPT_H1 ? "H1" : result == SequentialTest::ACCEPT_H0 ? "H0" : "no decision")
+		<< " after " << test.size() << " games" << endl;
+}
 int main() {
 	using std::cout; using  std::endl;
 
@@ -419,9 +2136,24 @@ int main() {
 	//const auto& ai = StringAIPair("beamSearchActionWithTimeThreshold", [](const State& state) {return beamSearchActionWithTimeThreshold(state, 200, 10); });
 	//const auto& ai = StringAIPair("chokudaiSearchAction", [](const State& state) {return chokudaiSearchAction(state, 1, 50, 20); });
 	//const auto& ai = StringAIPair("chokudaiSearchActionWithTimeThreshold", [](const State& state) {return chokudaiSearchActionWithTimeThreshold(state, 1, 50, 10); });
+	//const auto& ai = StringAIPair("nestedMonteCarloSearchAction", [](const State& state) {return nestedMonteCarloSearchAction(state, 1); });
+	//const auto& ai = StringAIPair("nestedMonteCarloSearchActionWithTimeThreshold", [](const State& state) {return nestedMonteCarloSearchActionWithTimeThreshold(state, 10); });
+	//const auto& ai = StringAIPair("mctsAction", [](const State& state) {return mctsAction(state, 1000); });
+	//const auto& ai = StringAIPair("mctsActionWithTimeThreshold", [](const State& state) {return mctsActionWithTimeThreshold(state, 10); });
+	//const auto& ai = StringAIPair("mctsActionWithNodeBudget", [](const State& state) {TreeStatistics statistics; const auto action = mctsActionWithTimeThreshold(state, 10, NodeBudget{/*m[h*/100000,/*oCg*/0,/*ŕ؂̂Ă邩*/true}, &statistics); std::cerr << "nodes " << statistics.node_number << " bytes " << statistics.byte_size << " pruned " << statistics.pruned_node_number << std::endl; return action; });
 	const auto& ai = StringAIPair("greedyAction", [](const State& state) {return greedyAction(state); });
 
+	//runSelfPlay("one_player_selfplay.bin",/*vC*/1000,/*1肠̃vCAEg*/1000,/*Xbh*/std::thread::hardware_concurrency(),/*Ֆʂ̍*/31,/*Ֆʂ̕*/11,/*Q[I^[*/100); // wKf[^
 	playGame(ai,/*Ֆʂ̍*/5,/*Ֆʂ̕*/5,/*Q[I^[*/3,/*Ֆʏ̃V[h*/0);
+	//playGame(ai,/*Ֆʂ̍*/5,/*Ֆʂ̕*/5,/*Q[I^[*/3,/*Ֆʏ̃V[h*/0,/*^[Ֆʂ\邩*/false); // Ֆʂ̕\Ōゾɂđ
+	//{ std::ofstream record_stream("game_records.txt"); for (int i = 0; i < 100; i++) recordGame(ai,/*Ֆʂ̍*/31,/*Ֆʂ̕*/11,/*Q[I^[*/100,/*Ֆʏ̃V[h*/i).write(record_stream); } // Ֆʂ\ɊL^
+	//replayGame("game_records.txt",/**/0,/*^[*/50); // L^̔ՖʂČ
+	//runFarm("/tmp/one_player_farm.sock", "farm_results.txt",/*vC*/1000, { ai, StringAIPair("randomAction", [](const State& state) {return randomAction(state); }) },/*[J[*/std::thread::hardware_concurrency(),/*Ֆʂ̍*/31,/*Ֆʂ̕*/11,/*Q[I^[*/100); // 2AI𕡐vZXŃvC
+	//runFarmCoordinator("/tmp/one_player_farm.sock", "farm_results.txt",/*vC*/1000,/*AI̐*/2); // [J[͕ʂɋN(numactlNUMAm[hƂɋNȂ)
+	//runFarmWorker("/tmp/one_player_farm.sock", { ai, StringAIPair("randomAction", [](const State& state) {return randomAction(state); }) },/*Ֆʂ̍*/31,/*Ֆʂ̕*/11,/*Q[I^[*/100); // R[fBl[^[ƓAIn
 	//testAiScore(ai,/*eXg*/10,/*Ֆʂ̍*/31,/*Ֆʂ̕*/11,/*Q[I^[*/100);
+	//mazefile::generateDirectory("mazes",/*H̐*/10,/*Ֆʂ̍*/999,/*Ֆʂ̕*/999,/*Q[I^[*/1000); // x`}[Np̖Ht@C
+	//testAiScore(ai, mazefile::loadDirectory("mazes")); // Ht@C̔ՖʂŃeXg
+	//testAiScoreDifferenceWithSprt(ai, StringAIPair("randomAction", [](const State& state) {return randomAction(state); }),/*őeXg*/1000,/*Ֆʂ̍*/31,/*Ֆʂ̕*/11,/*Q[I^[*/100,/*Η̃XRA*/10);
 	return 0;
 }
\ No newline at end of file
@@ -9,6 +9,28 @@
 #include <chrono>
 #include <queue>
 #include <algorithm>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <deque>
+#include <filesystem>
+#include <array>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <signal.h>
+#endif
 std::random_device rnd;
 std::mt19937 mt(rnd());
 
@@ -17,35 +39,197 @@ using Actions = std::vector<int>;
 using ScoreType = int64_t;
 constexpr const ScoreType INF = 1000000000LL;
 // ԂǗNX
+// Ԑ̕ύXƒf͕ʃXbhs
 class TimeKeeper
 {
 private:
     std::chrono::high_resolution_clock::time_point start_time_;
-    int64_t time_threshold_;
+    std::atomic<int64_t> time_threshold_;
+    std::atomic<bool> is_canceled_;
 
 public:
     // Ԑ~bPʂŎw肵ăCX^XB
     TimeKeeper(const int64_t &time_threshold)
         : start_time_(std::chrono::high_resolution_clock::now()),
-          time_threshold_(time_threshold)
+          time_threshold_(time_threshold),
+          is_canceled_(false)
     {
     }
 
-    // CX^Xw肵Ԑ𒴉߂肷B
+    // CX^Xw肵Ԑ𒴉߂Afꂽ肷B
     bool isTimeOver() const
     {
+        if (this->is_canceled_)
+            return true;
         auto diff = std::chrono::high_resolution_clock::now() - this->start_time_;
         return std::chrono::duration_cast<std::chrono::milliseconds>(diff).count() >= time_threshold_;
     }
+
+    // CX^X̎Ԑ~bPʂŕύXB
+    void setTimeThreshold(const int64_t time_threshold)
+    {
+        this->time_threshold_ = time_threshold;
+    }
+
+    // Ԑ҂ɒfB
+    void cancel()
+    {
+        this->is_canceled_ = true;
+    }
+};
+
+// 񓯊T̓ro
+struct SearchProgress
+{
+    std::atomic<Action> best_action_; // _̍őP
+    std::atomic<int64_t> iteration_;  // ̐(T̐[vCAEg)
+
+    SearchProgress() : best_action_(-1), iteration_(0) {}
+
+    // ro߂XV
+    void update(const Action best_action, const int64_t iteration)
+    {
+        this->best_action_ = best_action;
+        this->iteration_ = iteration;
+    }
+};
+
+// TƂɎyʂȗ(xoshiro128++)
+class Xoshiro128
+{
+private:
+    uint32_t s_[4];
+
+    static uint32_t rotl(const uint32_t x, const int k)
+    {
+        return (x << k) | (x >> (32 - k));
+    }
+
+public:
+    using result_type = uint32_t;
+
+    // V[hw肵ăCX^XBԂsplitmix64ŏ
+    explicit Xoshiro128(uint64_t seed = 0)
+    {
+        for (int i = 0; i < 4; i += 2)
+        {
+            uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            z ^= z >> 31;
+            this->s_[i] = (uint32_t)z;
+            this->s_[i + 1] = (uint32_t)(z >> 32);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    result_type operator()()
+    {
+        const uint32_t result = rotl(this->s_[0] + this->s_[3], 7) + this->s_[0];
+        const uint32_t t = this->s_[1] << 9;
+        this->s_[2] ^= this->s_[0];
+        this->s_[3] ^= this->s_[1];
+        this->s_[1] ^= this->s_[2];
+        this->s_[0] ^= this->s_[3];
+        this->s_[2] ^= t;
+        this->s_[3] = rotl(this->s_[3], 11);
+        return result;
+    }
 };
 static const std::string dstr[4] = {"RIGHT", "LEFT", "DOWN", "UP"};
 
+// ĤQ[ɕωȂǂƏ|CgBՖʂRs[Ă͋L
+// Ht@Cǂݍ񂾏ꍇmmap̈Rs[ɂ̂܂܎QƂ
+struct MazeBoard
+{
+    int h_ = 0;                           // H̍
+    int w_ = 0;                           // H̕
+    int end_turn_ = 0;                    // Q[I^[
+    int start_y_[2] = {};                 // eLN^[̏yW
+    int start_x_[2] = {};                 // eLN^[̏xW
+    const uint8_t *walls_ = nullptr;      // ǂꏊ1ŕ\By*w+x̏ɕׂ
+    const uint8_t *points_ = nullptr;     // ̏|Cg0~9ŕ\By*w+x̏ɕׂ
+    std::vector<uint8_t> buffer_;         // HƁAmmapłȂHt@C̎
+    std::shared_ptr<const void> mapping_; // mmap̈BŌɎQƂՖʂmunmap
+
+    MazeBoard() = default;
+    MazeBoard(const MazeBoard &) = delete;
+    MazeBoard &operator=(const MazeBoard &) = delete;
+};
+
+// |Cg}Xy*w+xŎW
+// 1^[Ɏ̂̓LN^[1l1}X܂łȂ̂ŁAI^[~LN^[ɊmۂĂ
+// Rs[Ămۗʂp̂ŁAՖʂi߂ƂvCAEg̓rŃq[vmۂȂ
+class EatenSquares
+{
+private:
+    std::vector<int> indices_;
+
+public:
+    EatenSquares() = default;
+    EatenSquares(EatenSquares &&) = default;
+    EatenSquares &operator=(EatenSquares &&) = default;
+
+    EatenSquares(const EatenSquares &other)
+    {
+        *this = other;
+    }
+
+    EatenSquares &operator=(const EatenSquares &other)
+    {
+        if (this != &other)
+        {
+            this->indices_.reserve(other.indices_.capacity());
+            this->indices_.assign(other.indices_.begin(), other.indices_.end());
+        }
+        return *this;
+    }
+
+    // }X̐̏mۂ
+    void reserve(const int capacity)
+    {
+        this->indices_.reserve(capacity);
+    }
+
+    // }Xindex̃|Cg肷
+    bool contains(const int index) const
+    {
+        return std::binary_search(this->indices_.begin(), this->indices_.end(), index);
+    }
+
+    // }XindexAVԂ
+    bool insert(const int index)
+    {
+        auto it = std::lower_bound(this->indices_.begin(), this->indices_.end(), index);
+        if (it != this->indices_.end() && *it == index)
+            return false;
+        this->indices_.insert(it, index);
+        return true;
+    }
+
+    // mۂĂoCgԂ
+    int64_t byteSize() const
+    {
+        return (int64_t)(this->indices_.capacity() * sizeof(int));
+    }
+
+    bool operator==(const EatenSquares &other) const
+    {
+        return this->indices_ == other.indices_;
+    }
+};
+
 // lQ[̗
 // 1^[ɏ㉺El̂ꂩɕǂ̂Ȃꏊ1}XiށB
 // ɂ|Cg𓥂ނƎg̃XRAƂȂÃ|CgB
 // END_TURN̎_̃XRAG荂
 class SimultaneousMazeState
 {
+public:
+    static constexpr const int MAX_ACTION_NUMBER = 4; // 1^[1l̃vC[\ȍs̍ő吔
+
 private:
     static constexpr const int END_TURN = 20;
     static constexpr const int dx[4] = {1, -1, 0, 0};
@@ -59,25 +243,82 @@ private:
     };
     int h_;
     int w_;
-    std::vector<std::vector<int>> walls_;
-    std::vector<std::vector<int>> points_;
+    int end_turn_;
+    std::shared_ptr<const MazeBoard> board_; // ǂƏ|Cg
+    EatenSquares eaten_;                     // |Cg}X
     int turn_;
     std::vector<Character> characters_;
 
+    // W(y,x)ɕǂ邩肷
+    bool isWall(const int y, const int x) const
+    {
+        return this->board_->walls_[y * this->w_ + x];
+    }
+
+    // W(y,x)̏ɎcĂ|CgԂ
+    int pointAt(const int y, const int x) const
+    {
+        const int index = y * this->w_ + x;
+        const int point = this->board_->points_[index];
+        if (point == 0 || this->eaten_.contains(index))
+        {
+            return 0;
+        }
+        return point;
+    }
+
+    // W(y,x)̏̃|Cg菜
+    void eat(const int y, const int x)
+    {
+        const int index = y * this->w_ + x;
+        if (this->board_->points_[index] != 0)
+            this->eaten_.insert(index);
+    }
+
 public:
-    Action first_action_;
+    Action first_action_;       // T؂̃[gm[hōŏɑIs
+    ScoreType evaluated_score_; // Tŕ]XRA
+
+    // ǂƏ|CgLH珉Ֆʂ
+    explicit SimultaneousMazeState(const std::shared_ptr<const MazeBoard> &board) : h_(board->h_),
+                                                                                   w_(board->w_),
+                                                                                   end_turn_(board->end_turn_),
+                                                                                   board_(board),
+                                                                                   turn_(0),
+                                                                                   characters_({Character(board->start_y_[0], board->start_x_[0]), Character(board->start_y_[1], board->start_x_[1])}),
+                                                                                   first_action_(-1),
+                                                                                   evaluated_score_(0)
+    {
+        this->eaten_.reserve(this->end_turn_ * 2);
+    }
+
     SimultaneousMazeState(const int h, const int w, const int seed) : h_(h),
                                                                       w_(w),
-                                                                      walls_(h, std::vector<int>(w)),
-                                                                      points_(h, std::vector<int>(w)),
+                                                                      end_turn_(END_TURN),
                                                                       turn_(0),
                                                                       characters_({Character(h / 2, (w / 2) - 1), Character(h / 2, (w / 2) + 1)}),
-                                                                      first_action_(-1)
+                                                                      first_action_(-1),
+                                                                      evaluated_score_(0)
     {
         if (h % 2 == 0 || w % 2 == 0)
         {
             throw std::string("h and w must be odd number");
         }
+        this->eaten_.reserve(this->end_turn_ * 2);
+        auto board = std::make_shared<MazeBoard>();
+        board->h_ = h;
+        board->w_ = w;
+        board->end_turn_ = END_TURN;
+        for (int player_id = 0; player_id < 2; player_id++)
+        {
+            board->start_y_[player_id] = this->characters_[player_id].y_;
+            board->start_x_[player_id] = this->characters_[player_id].x_;
+        }
+        board->buffer_.assign(2 * h * w, 0);
+        uint8_t *walls = board->buffer_.data();
+        uint8_t *points = walls + h * w;
+        board->walls_ = walls;
+        board->points_ = points;
         auto mt = std::mt19937(seed);
 
         auto check = std::vector<std::vector<int>>(h, std::vector<int>(w));
@@ -93,7 +334,7 @@ public:
                 int tx = x;
                 if (!check[ty][tx])
                 {
-                    this->walls_[ty][tx] = 1;
+                    walls[ty * w + tx] = 1;
                     check[ty][tx] = 1;
                 }
                 if (mt() % 10 > 50)
@@ -103,7 +344,7 @@ public:
                     tx += dx[direction];
                     if (!check[ty][tx])
                     {
-                        this->walls_[ty][tx] = 1;
+                        walls[ty * w + tx] = 1;
                         check[ty][tx] = 1;
                     }
                 }
@@ -116,16 +357,23 @@ public:
                 int point = mt() % 10;
                 if (!check[ty][tx])
                 {
-                    this->points_[ty][tx] = point;
+                    points[ty * w + tx] = point;
                     check[ty][tx] = 1;
                 }
                 tx = w - 1 - x;
                 if (!check[ty][tx])
                 {
-                    this->points_[ty][tx] = point;
+                    points[ty * w + tx] = point;
                     check[ty][tx] = 1;
                 }
             }
+        this->board_ = std::move(board);
+    }
+
+    // ǂƏ|CgԂ
+    const std::shared_ptr<const MazeBoard> &board() const
+    {
+        return this->board_;
     }
     // [ǂ̃Q[ł] : vC[0肷
     bool isWin() const
@@ -145,7 +393,7 @@ public:
     // [ǂ̃Q[ł] : Q[I肷
     bool isDone() const
     {
-        return this->turn_ == END_TURN;
+        return this->turn_ == this->end_turn_;
     }
     // [ǂ̃Q[ł] : w肵actionŃQ[1^[i߂
     void advance(const Action action0, const Action action1)
@@ -155,7 +403,7 @@ public:
             const auto &action = action0;
             character.x_ += dx[action];
             character.y_ += dy[action];
-            const auto point = this->points_[character.y_][character.x_];
+            const auto point = this->pointAt(character.y_, character.x_);
             if (point > 0)
             {
                 character.game_score_ += point;
@@ -166,7 +414,7 @@ public:
             const auto &action = action1;
             character.x_ += dx[action];
             character.y_ += dy[action];
-            const auto point = this->points_[character.y_][character.x_];
+            const auto point = this->pointAt(character.y_, character.x_);
             if (point > 0)
             {
                 character.game_score_ += point;
@@ -175,7 +423,7 @@ public:
 
         for (const auto &character : this->characters_)
         {
-            this->points_[character.y_][character.x_] = 0;
+            this->eat(character.y_, character.x_);
         }
         this->turn_++;
     }
@@ -189,7 +437,7 @@ public:
         {
             int ty = character.y_ + dy[action];
             int tx = character.x_ + dx[action];
-            if (ty >= 0 && ty < h_ && tx >= 0 && tx < w_ && !this->walls_[ty][tx])
+            if (ty >= 0 && ty < h_ && tx >= 0 && tx < w_ && !this->isWall(ty, tx))
             {
                 actions.emplace_back(action);
             }
@@ -197,6 +445,23 @@ public:
         return actions;
     }
 
+    // [ǂ̃Q[ł] : w肵vC[\ȍsq[vg킸actions֏݁A̐Ԃ
+    int legalActions(const int player_id, Action *actions) const
+    {
+        int action_number = 0;
+        const auto &character = this->characters_[player_id];
+        for (Action action = 0; action < 4; action++)
+        {
+            int ty = character.y_ + dy[action];
+            int tx = character.x_ + dx[action];
+            if (ty >= 0 && ty < h_ && tx >= 0 && tx < w_ && !this->isWall(ty, tx))
+            {
+                actions[action_number++] = action;
+            }
+        }
+        return action_number;
+    }
+
     // [ȂĂ悢ƕ֗] : vC[0̏vẐ߂̃XRAvZ
     double getFirstPlayerScoreForWinRate() const
     {
@@ -212,12 +477,70 @@ public:
             return 0.5;
     }
 
+    // [ȂĂ悢ƕ֗] : w肵vC[̃Q[̃XRAԂ
+    int gameScore(const int player_id) const
+    {
+        return this->characters_[player_id].game_score_;
+    }
+
+    // [ȂĂ悢ƕ֗] : w肵vC[_̒Tp̔Ֆʕ]
+    void evaluateScore(const int player_id)
+    {
+        this->evaluated_score_ = this->gameScore(player_id) - this->gameScore((player_id + 1) % 2);
+    }
+
+    // [ȂĂ悢ƕ֗] : Ֆʂ肷
+    bool operator==(const SimultaneousMazeState &other) const
+    {
+        if (this->turn_ != other.turn_)
+            return false;
+        for (int player_id = 0; player_id < (int)this->characters_.size(); player_id++)
+        {
+            const auto &character = this->characters_[player_id];
+            const auto &other_character = other.characters_[player_id];
+            if (character.y_ != other_character.y_ || character.x_ != other_character.x_ || character.game_score_ != other_character.game_score_)
+                return false;
+        }
+        return this->eaten_ == other.eaten_;
+    }
+
+    // [ȂĂ悢ƕ֗] : Ֆʂq[vɊmۂĂoCgԂBLĂH͊܂߂Ȃ
+    int64_t heapByteSize() const
+    {
+        return this->eaten_.byteSize() + this->characters_.capacity() * sizeof(Character);
+    }
+
+    // [ȂĂ悢ƕ֗] : wKf[^ɏoՖʂ̃oCgԂ
+    int encodedSize() const
+    {
+        return 9 * sizeof(int32_t) + 2 * this->h_ * this->w_;
+    }
+
+    // [ȂĂ悢ƕ֗] : wKf[^ɏo߁AՖʂbytesɏ
+    // AA^[AevC[yWxWƃXRAint32_tŕׁAĊe}X̃|Cgƕǂ1oCgׂ
+    void encode(uint8_t *bytes) const
+    {
+        const int32_t values[9] = {this->h_, this->w_, this->turn_,
+                                   this->characters_[0].y_, this->characters_[0].x_, this->characters_[0].game_score_,
+                                   this->characters_[1].y_, this->characters_[1].x_, this->characters_[1].game_score_};
+        std::memcpy(bytes, values, sizeof(values));
+        bytes += sizeof(values);
+        for (int y = 0; y < this->h_; y++)
+        {
+            for (int x = 0; x < this->w_; x++)
+            {
+                bytes[y * this->w_ + x] = (uint8_t)this->pointAt(y, x);
+            }
+        }
+        std::memcpy(bytes + this->h_ * this->w_, this->board_->walls_, this->h_ * this->w_);
+    }
+
     // [ȂĂ悢ƕ֗] : ݂̃Q[󋵂𕶎ɂ
     std::string toString() const
     {
         std::stringstream ss("");
         ss << "turn:\t" << this->turn_ << "\n";
-        for (int player_id = 0; player_id < this->characters_.size(); player_id++)
+        for (int player_id = 0; player_id < (int)this->characters_.size(); player_id++)
         {
             ss << "score(" << player_id << "):\t" << this->characters_[player_id].game_score_ << "\n";
         }
@@ -226,11 +549,11 @@ public:
             for (int w = 0; w < this->w_; w++)
             {
                 char c = '.';
-                if (this->walls_[h][w])
+                if (this->isWall(h, w))
                 {
                     c = '#';
                 }
-                for (int player_id = 0; player_id < this->characters_.size(); player_id++)
+                for (int player_id = 0; player_id < (int)this->characters_.size(); player_id++)
                 {
                     const auto &character = this->characters_[player_id];
                     if (character.y_ == h && character.x_ == w)
@@ -238,9 +561,9 @@ public:
                         c = 'A' + (player_id);
                     }
                 }
-                if (this->points_[h][w])
+                if (this->pointAt(h, w))
                 {
-                    c = '0' + (char)points_[h][w];
+                    c = '0' + (char)this->pointAt(h, w);
                 }
                 ss << c;
             }
@@ -250,6 +573,12 @@ public:
         return ss.str();
     }
 };
+
+// [ȂĂ悢ƕ֗] : T̃\[gpɕ]r
+bool operator<(const SimultaneousMazeState &maze_1, const SimultaneousMazeState &maze_2)
+{
+    return maze_1.evaluated_score_ < maze_2.evaluated_score_;
+}
 using State = SimultaneousMazeState;
 
 // w肵vC[̍s_Ɍ肷
@@ -258,6 +587,14 @@ Action randomAction(const State &state, const int player_id)
     auto legal_actions = state.legalActions(player_id);
     return legal_actions[mt() % (legal_actions.size())];
 }
+
+// TƂ̗gAq[vg킸Ɏw肵vC[̍s_Ɍ肷
+Action randomAction(const State &state, const int player_id, Xoshiro128 &rng)
+{
+    Action legal_actions[State::MAX_ACTION_NUMBER];
+    const int action_number = state.legalActions(player_id, legal_actions);
+    return legal_actions[rng() % action_number];
+}
 namespace montecarlo
 {
     // z̍ől̃CfbNXԂ
@@ -265,26 +602,31 @@ namespace montecarlo
     {
         return std::distance(x.begin(), std::max_element(x.begin(), x.end()));
     }
-    //vC[0_ł̕]
-    double playout(State *state)
-    { // const&ɂƍċAɃfB[vRs[KvɂȂ邽߁Â߃|C^ɂB(constłȂQƂł)
+    // vC[0_ł̕]
+    // ċAɃ[vŐi߁Aq[vmۂȂ
+    double playout(State *state, Xoshiro128 &rng)
+    { // const&ɂƃfB[vRs[KvɂȂ邽߁Â߃|C^ɂB(constłȂQƂł)
+        while (!state->isDone())
+        {
+            const Action action0 = randomAction(*state, 0, rng);
+            const Action action1 = randomAction(*state, 1, rng);
+            state->advance(action0, action1);
+        }
         if (state->isWin())
             return 1;
         if (state->isLose())
             return 0;
-        if (state->isDraw())
-            return 0.5;
-        state->advance(randomAction(*state, 0), randomAction(*state, 1));
-        return playout(state);
+        return 0.5;
     }
     // (ms)w肵ČneJ@Ŏw肵vC[̍s肷
     Action primitiveMontecarloAction(const State &state, const int player_id, const int playout_number)
     {
+        Xoshiro128 rng(mt());
         auto my_legal_actions = state.legalActions(player_id);
         auto opp_legal_actions = state.legalActions((player_id + 1) % 2);
         double best_value = -INF;
         int best_i = -1;
-        for (int i = 0; i < my_legal_actions.size(); i++)
+        for (int i = 0; i < (int)my_legal_actions.size(); i++)
         {
             double value = 0;
             for (int j = 0; j < playout_number; j++)
@@ -292,13 +634,13 @@ namespace montecarlo
                 State next_state = state;
                 if (player_id == 0)
                 {
-                    next_state.advance(my_legal_actions[i], opp_legal_actions[mt() % opp_legal_actions.size()]);
+                    next_state.advance(my_legal_actions[i], opp_legal_actions[rng() % opp_legal_actions.size()]);
                 }
                 else
                 {
-                    next_state.advance(opp_legal_actions[mt() % opp_legal_actions.size()], my_legal_actions[i]);
+                    next_state.advance(opp_legal_actions[rng() % opp_legal_actions.size()], my_legal_actions[i]);
                 }
-                double player0_win_rate = playout(&next_state);
+                double player0_win_rate = playout(&next_state, rng);
                 double win_rate = (player_id == 0 ? player0_win_rate : 1. - player0_win_rate);
                 value += win_rate;
             }
@@ -310,22 +652,236 @@ namespace montecarlo
         }
         return my_legal_actions[best_i];
     }
+    constexpr const int FICTITIOUS_PLAY_ITERATION = 1000; // s̋ύt߂鉼zvC̔
+
+    // vC[0̗payoff[i][j]AvC[1̗1-payoff[i][j]̍sQ[̍헪̋ύtzvCŋߎ
+    // evC[̉ߋ̍spxւ̍œKJԂA̕pxstrategiesɏ
+    void solveMatrixGame(const std::vector<std::vector<double>> &payoff, std::vector<double> *strategies)
+    {
+        const int i_size = payoff.size();
+        const int j_size = payoff[0].size();
+        std::vector<double> payoff_sums[2] = {std::vector<double>(i_size), std::vector<double>(j_size)}; // ̍spxɑ΂es̗̘a
+        strategies[0].assign(i_size, 0);
+        strategies[1].assign(j_size, 0);
+        int best_is[2] = {0, 0};
+        for (int t = 0; t < FICTITIOUS_PLAY_ITERATION; t++)
+        {
+            ++strategies[0][best_is[0]];
+            ++strategies[1][best_is[1]];
+            for (int i = 0; i < i_size; i++)
+            {
+                payoff_sums[0][i] += payoff[i][best_is[1]];
+            }
+            for (int j = 0; j < j_size; j++)
+            {
+                payoff_sums[1][j] += 1. - payoff[best_is[0]][j];
+            }
+            for (int player_id = 0; player_id < 2; player_id++)
+            {
+                best_is[player_id] = argMax(payoff_sums[player_id]);
+            }
+        }
+        for (int player_id = 0; player_id < 2; player_id++)
+        {
+            for (auto &probability : strategies[player_id])
+            {
+                probability /= FICTITIOUS_PLAY_ITERATION;
+            }
+        }
+    }
+
+    // s̋ύtōłm̍w肵vC[̍s̃CfbNXԂ
+    int matrixGameBestIndex(const std::vector<std::vector<double>> &payoff, const int player_id)
+    {
+        std::vector<double> strategies[2];
+        solveMatrixGame(payoff, strategies);
+        return argMax(strategies[player_id]);
+    }
+
+    // vCAEg񐔂w肵āAs̑gƂ̌neJ@ŗsA
+    // ̋ύtw肵vC[̍s肷
+    Action primitiveMontecarloNashAction(const State &state, const int player_id, const int playout_number)
+    {
+        Xoshiro128 rng(mt());
+        auto legal_actions0 = state.legalActions(0);
+        auto legal_actions1 = state.legalActions(1);
+        auto payoff = std::vector<std::vector<double>>(legal_actions0.size(), std::vector<double>(legal_actions1.size()));
+        for (int i = 0; i < (int)legal_actions0.size(); i++)
+        {
+            for (int j = 0; j < (int)legal_actions1.size(); j++)
+            {
+                for (int k = 0; k < playout_number; k++)
+                {
+                    State next_state = state;
+                    next_state.advance(legal_actions0[i], legal_actions1[j]);
+                    payoff[i][j] += playout(&next_state, rng);
+                }
+                payoff[i][j] /= playout_number;
+            }
+        }
+        const int best_index = matrixGameBestIndex(payoff, player_id);
+        return (player_id == 0 ? legal_actions0 : legal_actions1)[best_index];
+    }
+
     constexpr const double C = 1.;            // UCB1̌vZɎg萔
     constexpr const int EXPAND_THRESHOLD = 5; // m[hWJ臒l
+    constexpr const double EXP3_GAMMA = 0.2;   // Exp3ňlz銄
+    constexpr const double REGRET_MATCHING_GAMMA = 0.3; // Regret Matchingňlz銄
+
+    // ̊em[hōsIԕ
+    enum class SelectionPolicy
+    {
+        UCB1,            // vC[ƂUCB1őI(DUCT)
+        EXP3,            // Exp3̍헪TvO
+        REGRET_MATCHING, // ݐόɔႷ鍬헪TvO
+    };
+
+    // T؂̑傫̏Bǂ0ȂȂ
+    struct NodeBudget
+    {
+        int64_t max_node_number = 0; // m[h̏
+        int64_t max_byte_size = 0;   // m[hgoCg̏
+        bool recycles = false;       // ɒB玎s񐔂̏Ȃ؂̂Ăċ󂫂BfalseȂWJ~߂
+    };
+
+    // T؂̃gp
+    struct TreeStatistics
+    {
+        int64_t node_number = 0;        // m[h
+        int64_t byte_size = 0;          // m[hgoCg
+        int64_t pruned_node_number = 0; // 󂫂邽߂Ɏ̂Ăm[h̉א
+    };
+
+    // T؂̃m[hƃoCg𐔂AƔׂ
+    // m[h͐ƓWJɎ̎goCg𑫂AjɈ
+    struct NodeCounter
+    {
+        NodeBudget budget_;
+        TreeStatistics statistics_;
+        bool needs_recycle_ = false; // ̂ߓWJłȂm[hA̕]̑Oɋ󂫂
+
+        NodeCounter(const NodeBudget &budget = NodeBudget()) : budget_(budget) {}
+
+        // ɒB肷
+        bool isFull() const
+        {
+            return (this->budget_.max_node_number > 0 && this->statistics_.node_number >= this->budget_.max_node_number) ||
+                   (this->budget_.max_byte_size > 0 && this->statistics_.byte_size >= this->budget_.max_byte_size);
+        }
+    };
 
     // DUCŤvZɎgm[h
+    // qm[h̓vʂ̓vC[ƍsƂ̎ӘaƂĎAt`dɍXV
+    // qm[h͏߂đI΂ꂽƂɐA܂ł͋̃|C^uĂ
+    // counternƃm[hƃoCg𐔂AɒBqm[h炸ɃvCAEgŕ]
     class Node
     {
     private:
         State state_;
+        NodeCounter *counter_;
+        int64_t counted_byte_size_; // counterɑĂ邱̃m[h̃oCg
         double w_;
+        Actions legal_actionses_[2];        // WJ̃vC[Ƃ̍@
+        std::vector<double> action_ws_[2]; // vC[ƍsƂ̃vC[0_̕]l̘a
+        std::vector<double> action_ns_[2]; // vC[ƍsƂ̎s
+        double t_;                          // qm[h̎s񐔂̘a
+        int unvisited_cursor_;              // ܂sĂȂqm[h̒ʂԍ
+        SelectionPolicy policy_;
+        std::vector<double> strategies_[2];     // ȎIŎgvC[Ƃ̍헪
+        std::vector<double> action_gains_[2];   // Exp3̐ݐϕVA܂Regret Matching̗ݐό
+        std::vector<double> strategy_sums_[2];  // 헪̗ݐϘaBKƕϐ헪ɂȂ
+
+        // ̃m[hgoCg𐔂Acounterɔf
+        void recount()
+        {
+            if (this->counter_ == nullptr)
+                return;
+            int64_t byte_size = sizeof(Node) + this->state_.heapByteSize() + this->child_nodeses.capacity() * sizeof(this->child_nodeses[0]);
+            for (int player_id = 0; player_id < 2; player_id++)
+            {
+                byte_size += this->legal_actionses_[player_id].capacity() * sizeof(Action);
+                byte_size += (this->action_ws_[player_id].capacity() + this->action_ns_[player_id].capacity() + this->strategies_[player_id].capacity() + this->action_gains_[player_id].capacity() + this->strategy_sums_[player_id].capacity()) * sizeof(double);
+            }
+            for (const auto &child_nodes : this->child_nodeses)
+            {
+                byte_size += child_nodes.capacity() * sizeof(child_nodes[0]);
+            }
+            this->counter_->statistics_.byte_size += byte_size - this->counted_byte_size_;
+            this->counted_byte_size_ = byte_size;
+        }
+
+        // ɒBĂāAVm[hWJɎgmۂłȂ肷
+        bool isOverBudget()
+        {
+            if (this->counter_ == nullptr || !this->counter_->isFull())
+                return false;
+            this->counter_->needs_recycle_ = this->counter_->budget_.recycles;
+            return true;
+        }
+
+        // EXP3܂REGRET_MATCHINGŎw肵vC[݂̌̍헪strategies_ɌvZ
+        void computeStrategy(const int player_id)
+        {
+            const auto &gains = this->action_gains_[player_id];
+            auto &strategy = this->strategies_[player_id];
+            const int size = gains.size();
+            double sum = 0;
+            if (this->policy_ == SelectionPolicy::EXP3)
+            {
+                const double eta = EXP3_GAMMA / size;
+                const double max_gain = *std::max_element(gains.begin(), gains.end());
+                for (int i = 0; i < size; i++)
+                {
+                    strategy[i] = std::exp(eta * (gains[i] - max_gain));
+                    sum += strategy[i];
+                }
+                for (int i = 0; i < size; i++)
+                {
+                    strategy[i] = (1. - EXP3_GAMMA) * strategy[i] / sum + EXP3_GAMMA / size;
+                }
+            }
+            else
+            {
+                for (int i = 0; i < size; i++)
+                {
+                    strategy[i] = std::max(gains[i], 0.);
+                    sum += strategy[i];
+                }
+                for (int i = 0; i < size; i++)
+                {
+                    strategy[i] = sum > 0 ? (1. - REGRET_MATCHING_GAMMA) * strategy[i] / sum + REGRET_MATCHING_GAMMA / size : 1. / size;
+                }
+            }
+        }
+
+        // I񂾍s̕VAw肵vC[Exp3̐ݐϕV܂Regret Matching̗ݐόXV
+        void updateGains(const int player_id, const int selected, const double reward)
+        {
+            const auto &strategy = this->strategies_[player_id];
+            auto &gains = this->action_gains_[player_id];
+            auto &strategy_sums = this->strategy_sums_[player_id];
+            const double estimated_reward = reward / strategy[selected]; // I΂ꂽmŊĕsΐɂ
+            for (int i = 0; i < (int)gains.size(); i++)
+            {
+                if (this->policy_ == SelectionPolicy::EXP3)
+                {
+                    if (i == selected)
+                        gains[i] += estimated_reward;
+                }
+                else
+                {
+                    gains[i] += (i == selected ? estimated_reward : 0.) - reward;
+                }
+                strategy_sums[i] += strategy[i];
+            }
+        }
 
     public:
-        std::vector<std::vector<Node>> child_nodeses;
+        std::vector<std::vector<std::unique_ptr<Node>>> child_nodeses;
         double n_;
 
         // m[h̕]s
-        double evaluate()
+        double evaluate(Xoshiro128 &rng)
         {
             if (this->state_.isDone())
             {
@@ -341,18 +897,45 @@ namespace montecarlo
             if (this->child_nodeses.empty())
             {
                 State state_copy = this->state_;
-                double value = playout(&state_copy);
+                double value = playout(&state_copy, rng);
                 this->w_ += value;
                 ++this->n_;
 
-                if (this->n_ == EXPAND_THRESHOLD)
+                if (this->n_ >= EXPAND_THRESHOLD && !this->isOverBudget())
                     this->expand();
 
                 return value;
             }
             else
             {
-                double value = this->nextChiledNode().evaluate();
+                int is[2];
+                this->nextChiledNode(is, rng);
+                auto &child_node = this->child_nodeses[is[0]][is[1]];
+                double value;
+                if (!child_node && this->isOverBudget())
+                {
+                    State state_copy = this->state_;
+                    state_copy.advance(this->legal_actionses_[0][is[0]], this->legal_actionses_[1][is[1]]);
+                    value = playout(&state_copy, rng);
+                }
+                else
+                {
+                    if (!child_node)
+                    {
+                        child_node = std::make_unique<Node>(this->state_, this->policy_, this->counter_);
+                        child_node->state_.advance(this->legal_actionses_[0][is[0]], this->legal_actionses_[1][is[1]]);
+                        child_node->recount();
+                    }
+                    value = child_node->evaluate(rng);
+                }
+                for (int player_id = 0; player_id < 2; player_id++)
+                {
+                    this->action_ws_[player_id][is[player_id]] += value;
+                    ++this->action_ns_[player_id][is[player_id]];
+                    if (this->policy_ != SelectionPolicy::UCB1)
+                        this->updateGains(player_id, is[player_id], player_id == 0 ? value : 1. - value);
+                }
+                ++this->t_;
                 this->w_ += value;
                 ++this->n_;
                 return value;
@@ -361,211 +944,1507 @@ namespace montecarlo
         // m[hWJ
         void expand()
         {
-            auto legal_actions0 = this->state_.legalActions(0);
-            auto legal_actions1 = this->state_.legalActions(1);
-            this->child_nodeses.clear();
-            for (const auto &action0 : legal_actions0)
+            for (int player_id = 0; player_id < 2; player_id++)
             {
-                this->child_nodeses.emplace_back();
-                auto &target_nodes = this->child_nodeses.back();
-                for (const auto &action1 : legal_actions1)
+                this->legal_actionses_[player_id] = this->state_.legalActions(player_id);
+                this->action_ws_[player_id].assign(this->legal_actionses_[player_id].size(), 0);
+                this->action_ns_[player_id].assign(this->legal_actionses_[player_id].size(), 0);
+                if (this->policy_ != SelectionPolicy::UCB1)
                 {
-                    target_nodes.emplace_back(this->state_);
-                    auto &target_node = target_nodes.back();
-                    target_node.state_.advance(action0, action1);
+                    this->strategies_[player_id].assign(this->legal_actionses_[player_id].size(), 0);
+                    this->action_gains_[player_id].assign(this->legal_actionses_[player_id].size(), 0);
+                    this->strategy_sums_[player_id].assign(this->legal_actionses_[player_id].size(), 0);
                 }
             }
+            this->child_nodeses.clear();
+            this->child_nodeses.resize(this->legal_actionses_[0].size());
+            for (auto &child_nodes : this->child_nodeses)
+            {
+                child_nodes.resize(this->legal_actionses_[1].size());
+            }
+            this->t_ = 0;
+            this->unvisited_cursor_ = 0;
+            this->recount();
         }
-        // ǂ̃m[h]邩I
-        Node &nextChiledNode()
+
+        // s񐔂min_nȏ̎qm[hcƂ̕؂̃m[hԂ
+        int64_t keptNodeNumber(const double min_n) const
         {
-            for (auto &child_nodes : this->child_nodeses)
+            int64_t node_number = 1;
+            for (const auto &child_nodes : this->child_nodeses)
             {
-                for (auto &child_node : child_nodes)
+                for (const auto &child_node : child_nodes)
                 {
-                    if (child_node.n_ == 0)
-                        return child_node;
+                    if (child_node && child_node->n_ >= min_n)
+                        node_number += child_node->keptNodeNumber(min_n);
                 }
             }
-            double t = 0;
+            return node_number;
+        }
+
+        // s񐔂min_n̎qm[h𕔕؂Ɣj
+        // qm[h̓v͂̃m[h̎ӘaɎcĂ̂ŁAjqm[h͎ɑI΂ꂽƂɍ蒼
+        void prune(const double min_n)
+        {
             for (auto &child_nodes : this->child_nodeses)
             {
                 for (auto &child_node : child_nodes)
                 {
-                    t += child_node.n_;
+                    if (!child_node)
+                        continue;
+                    if (child_node->n_ < min_n)
+                        child_node.reset();
+                    else
+                        child_node->prune(min_n);
                 }
             }
-            int best_is[] = {-1, -1};
+        }
 
-            double best_value = -INF;
-            for (int i = 0; i < this->child_nodeses.size(); i++)
+        // s񐔂̏Ȃqm[h畔؂Ǝ̂āAm[h𔼕ȉɂB[gm[hŌĂ
+        void recycle()
+        {
+            if (this->counter_ == nullptr)
+                return;
+            const int64_t node_number = this->counter_->statistics_.node_number;
+            int64_t low = 0;
+            int64_t high = (int64_t)this->n_ + 1;
+            while (low < high)
             {
-                const auto &childe_nodes = this->child_nodeses[i];
-                double w = 0;
-                double n = 0;
-                for (int j = 0; j < childe_nodes.size(); j++)
-                {
-                    const auto &child_node = childe_nodes[j];
-                    w += child_node.w_;
-                    n += child_node.n_;
-                }
-                double bias = std::sqrt(2. * std::log(t) / n);
-
-                double ucb1_value = w / n + (double)C * std::sqrt(2. * std::log(t) / n);
-                if (ucb1_value > best_value)
-                {
-                    best_is[0] = i;
-                    best_value = ucb1_value;
-                }
+                const int64_t mid = (low + high) / 2;
+                if (this->keptNodeNumber((double)mid) <= node_number / 2)
+                    high = mid;
+                else
+                    low = mid + 1;
             }
-            best_value = -INF;
-            for (int j = 0; j < this->child_nodeses[0].size(); j++)
+            this->prune((double)low);
+            this->counter_->statistics_.pruned_node_number += node_number - this->counter_->statistics_.node_number;
+            this->counter_->needs_recycle_ = false;
+        }
+        // ǂ̃m[h]邩IAvC[Ƃ̍s̃CfbNXisɏ
+        void nextChiledNode(int *is, Xoshiro128 &rng)
+        {
+            if (this->policy_ != SelectionPolicy::UCB1)
             {
-                double w = 0;
-                double n = 0;
-                for (int i = 0; i < this->child_nodeses.size(); i++)
+                for (int player_id = 0; player_id < 2; player_id++)
                 {
-                    const auto &child_node = child_nodeses[i][j];
-                    w += child_node.w_;
-                    n += child_node.n_;
+                    this->computeStrategy(player_id);
+                    const auto &strategy = this->strategies_[player_id];
+                    double r = (double)rng() / ((double)Xoshiro128::max() + 1.);
+                    is[player_id] = strategy.size() - 1;
+                    for (int i = 0; i < (int)strategy.size(); i++)
+                    {
+                        r -= strategy[i];
+                        if (r < 0)
+                        {
+                            is[player_id] = i;
+                            break;
+                        }
+                    }
                 }
-                double bias = std::sqrt(2. * std::log(t) / n);
-
-                double ucb1_value = (1 - w / n) + (double)C * std::sqrt(2. * std::log(t) / n);
-                if (ucb1_value > best_value)
+                return;
+            }
+            const int i_size = this->action_ns_[0].size();
+            const int j_size = this->action_ns_[1].size();
+            if (this->unvisited_cursor_ < i_size * j_size)
+            {
+                is[0] = this->unvisited_cursor_ / j_size;
+                is[1] = this->unvisited_cursor_ % j_size;
+                ++this->unvisited_cursor_;
+                return;
+            }
+            const double log_t = std::log(this->t_);
+            for (int player_id = 0; player_id < 2; player_id++)
+            {
+                const auto &ws = this->action_ws_[player_id];
+                const auto &ns = this->action_ns_[player_id];
+                double best_value = -INF;
+                for (int i = 0; i < (int)ns.size(); i++)
                 {
-                    best_is[1] = j;
-                    best_value = ucb1_value;
+                    const double player0_win_rate = ws[i] / ns[i];
+                    const double win_rate = player_id == 0 ? player0_win_rate : 1. - player0_win_rate;
+                    double ucb1_value = win_rate + (double)C * std::sqrt(2. * log_t / ns[i]);
+                    if (ucb1_value > best_value)
+                    {
+                        is[player_id] = i;
+                        best_value = ucb1_value;
+                    }
                 }
             }
+        }
 
-            return this->child_nodeses[best_is[0]][best_is[1]];
+        // m[h̔ՖʂԂ
+        const State &state() const
+        {
+            return this->state_;
         }
 
-        Node(const State &state) : state_(state), w_(0), n_(0) {}
-    };
+        // w肵vC[̍sƂ̎s񐔂Ԃ
+        const std::vector<double> &actionCounts(const int player_id) const
+        {
+            return this->action_ns_[player_id];
+        }
+
+        // qm[h̃vC[0_̕ϕ]l𗘓sɂĕԂBs̎qm[h͈ɂ
+        std::vector<std::vector<double>> payoffMatrix() const
+        {
+            auto payoff = std::vector<std::vector<double>>(this->child_nodeses.size(), std::vector<double>(this->child_nodeses[0].size(), 0.5));
+            for (int i = 0; i < (int)this->child_nodeses.size(); i++)
+            {
+                for (int j = 0; j < (int)this->child_nodeses[i].size(); j++)
+                {
+                    const auto &child_node = this->child_nodeses[i][j];
+                    if (child_node && child_node->n_ > 0)
+                        payoff[i][j] = child_node->w_ / child_node->n_;
+                }
+            }
+            return payoff;
+        }
+
+        // WJ̎w肵vC[̍@Ԃ
+        const Actions &legalActions(const int player_id) const
+        {
+            return this->legal_actionses_[player_id];
+        }
+
+        // w肵vC[̍s߂
+        // UCB1ł͍łs񐔂̑sAEXP3REGRET_MATCHINGł͕ϐ헪ōłm̍sԂ
+        Action bestAction(const int player_id) const
+        {
+            if (this->policy_ != SelectionPolicy::UCB1)
+            {
+                const auto &strategy_sums = this->strategy_sums_[player_id];
+                return this->legal_actionses_[player_id][std::distance(strategy_sums.begin(), std::max_element(strategy_sums.begin(), strategy_sums.end()))];
+            }
+            const auto &ns = this->action_ns_[player_id];
+            return this->legal_actionses_[player_id][std::distance(ns.begin(), std::max_element(ns.begin(), ns.end()))];
+        }
+
+        Node(const State &state, const SelectionPolicy policy = SelectionPolicy::UCB1, NodeCounter *counter = nullptr) : state_(state), counter_(counter), counted_byte_size_(0), w_(0), t_(0), unvisited_cursor_(0), policy_(policy), n_(0)
+        {
+            if (this->counter_ != nullptr)
+            {
+                ++this->counter_->statistics_.node_number;
+                this->recount();
+            }
+        }
+
+        ~Node()
+        {
+            if (this->counter_ != nullptr)
+            {
+                --this->counter_->statistics_.node_number;
+                this->counter_->statistics_.byte_size -= this->counted_byte_size_;
+            }
+        }
+    };
+
+    // vCAEgw肵DUCTŎw肵vC[̍s肷
+    Action ductAction(const State &state, const int player_id, const int playout_number)
+    {
+        Xoshiro128 rng(mt());
+        Node root_node = Node(state);
+        root_node.expand();
+        for (int i = 0; i < playout_number; i++)
+        {
+            root_node.evaluate(rng);
+        }
+        return root_node.bestAction(player_id);
+    }
+
+    // vCAEgw肵DUCTŒTA[g̗s̋ύtw肵vC[̍s肷
+    Action ductNashAction(const State &state, const int player_id, const int playout_number)
+    {
+        Xoshiro128 rng(mt());
+        Node root_node = Node(state);
+        root_node.expand();
+        for (int i = 0; i < playout_number; i++)
+        {
+            root_node.evaluate(rng);
+        }
+        return root_node.legalActions(player_id)[matrixGameBestIndex(root_node.payoffMatrix(), player_id)];
+    }
+
+    // (ms)w肵DUCTŒTA[g̗s̋ύtw肵vC[̍s肷
+    Action ductNashActionWithTimeThreshold(const State &state, const int player_id, const int64_t time_threshold)
+    {
+        Xoshiro128 rng(mt());
+        Node root_node = Node(state);
+        root_node.expand();
+        auto time_keeper = TimeKeeper(time_threshold);
+        while (!time_keeper.isTimeOver())
+        {
+            root_node.evaluate(rng);
+        }
+        return root_node.legalActions(player_id)[matrixGameBestIndex(root_node.payoffMatrix(), player_id)];
+    }
+
+    constexpr const int PROGRESS_INTERVAL = 256; // ro߂XVvCAEg̊Ԋu
+
+    // time_keeper~߂܂DUCTŒTA񐔂Ƃ̎w肵vC[̍őPprogressɏ
+    // budgetŒT؂̑傫𐧌łAstatisticsnƒTĨgpʂ
+    Action ductActionWithTimeKeeper(const State &state, const int player_id, const TimeKeeper &time_keeper, SearchProgress *progress = nullptr, const NodeBudget &budget = NodeBudget(), TreeStatistics *statistics = nullptr)
+    {
+        Xoshiro128 rng(mt());
+        NodeCounter counter(budget);
+        Node root_node = Node(state, SelectionPolicy::UCB1, &counter);
+        root_node.expand();
+        for (int cnt = 0;; cnt++)
+        {
+            if (time_keeper.isTimeOver())
+            {
+                break;
+            }
+            if (counter.needs_recycle_)
+                root_node.recycle();
+            root_node.evaluate(rng);
+            if (progress != nullptr && cnt % PROGRESS_INTERVAL == 0)
+                progress->update(root_node.bestAction(player_id), cnt + 1);
+        }
+        if (statistics != nullptr)
+            *statistics = counter.statistics_;
+        return root_node.bestAction(player_id);
+    }
+
+    // (ms)w肵DUCTŎw肵vC[̍s肷
+    Action ductActionWithTimeThreshold(const State &state, const int player_id, const int64_t time_threshold, const NodeBudget &budget = NodeBudget(), TreeStatistics *statistics = nullptr)
+    {
+        auto time_keeper = TimeKeeper(time_threshold);
+        return ductActionWithTimeKeeper(state, player_id, time_keeper, nullptr, budget, statistics);
+    }
+
+    // vCAEgƑIw肵ēMCTSŎw肵vC[̍s肷
+    Action simultaneousMctsAction(const State &state, const int player_id, const int playout_number, const SelectionPolicy policy)
+    {
+        Xoshiro128 rng(mt());
+        Node root_node = Node(state, policy);
+        root_node.expand();
+        for (int i = 0; i < playout_number; i++)
+        {
+            root_node.evaluate(rng);
+        }
+        return root_node.bestAction(player_id);
+    }
+
+    // (ms)ƑIw肵ēMCTSŎw肵vC[̍s肷
+    Action simultaneousMctsActionWithTimeThreshold(const State &state, const int player_id, const int64_t time_threshold, const SelectionPolicy policy)
+    {
+        Xoshiro128 rng(mt());
+        Node root_node = Node(state, policy);
+        root_node.expand();
+        auto time_keeper = TimeKeeper(time_threshold);
+        while (!time_keeper.isTimeOver())
+        {
+            root_node.evaluate(rng);
+        }
+        return root_node.bestAction(player_id);
+    }
+
+    // vCAEgw肵Exp3Ŏw肵vC[̍s肷
+    Action exp3Action(const State &state, const int player_id, const int playout_number)
+    {
+        return simultaneousMctsAction(state, player_id, playout_number, SelectionPolicy::EXP3);
+    }
+
+    // (ms)w肵Exp3Ŏw肵vC[̍s肷
+    Action exp3ActionWithTimeThreshold(const State &state, const int player_id, const int64_t time_threshold)
+    {
+        return simultaneousMctsActionWithTimeThreshold(state, player_id, time_threshold, SelectionPolicy::EXP3);
+    }
+
+    // vCAEgw肵Regret MatchingŎw肵vC[̍s肷
+    Action regretMatchingAction(const State &state, const int player_id, const int playout_number)
+    {
+        return simultaneousMctsAction(state, player_id, playout_number, SelectionPolicy::REGRET_MATCHING);
+    }
+
+    // (ms)w肵Regret MatchingŎw肵vC[̍s肷
+    Action regretMatchingActionWithTimeThreshold(const State &state, const int player_id, const int64_t time_threshold)
+    {
+        return simultaneousMctsActionWithTimeThreshold(state, player_id, time_threshold, SelectionPolicy::REGRET_MATCHING);
+    }
+
+    // Ԃ܂œƗDUCT̒T؂A[gł̎w肵vC[̍sƂ̎s񐔂action_countsɏ
+    void ductRootActionCounts(const State &state, const int player_id, const TimeKeeper &time_keeper, const uint64_t seed, std::vector<double> *action_counts)
+    {
+        Xoshiro128 rng(seed);
+        Node root_node = Node(state);
+        root_node.expand();
+        while (!time_keeper.isTimeOver())
+        {
+            root_node.evaluate(rng);
+        }
+        *action_counts = root_node.actionCounts(player_id);
+    }
+
+    // (ms)ƃXbhw肵āAXbhƂɓƗDUCT̒T؂A
+    // [g̎s񐔂ZĎw肵vC[̍s肷
+    Action ductActionWithTimeThresholdParallel(const State &state, const int player_id, const int64_t time_threshold, const int thread_number)
+    {
+        auto time_keeper = TimeKeeper(time_threshold);
+        std::vector<std::vector<double>> action_countses(thread_number);
+        std::vector<std::thread> threads;
+        for (int thread_id = 0; thread_id < thread_number; thread_id++)
+        {
+            threads.emplace_back(ductRootActionCounts, std::cref(state), player_id, std::cref(time_keeper), (uint64_t)mt(), &action_countses[thread_id]);
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        auto legal_actions = state.legalActions(player_id);
+        std::vector<double> action_counts(legal_actions.size());
+        for (const auto &counts : action_countses)
+        {
+            for (int i = 0; i < (int)counts.size(); i++)
+            {
+                action_counts[i] += counts[i];
+            }
+        }
+        return legal_actions[argMax(action_counts)];
+    }
+
+    // Ԃ܂ŒT؂ėpDUCT
+    class DuctSearcher
+    {
+    private:
+        NodeCounter counter_; // m[hɔjȂ悤ɐ錾
+        std::unique_ptr<Node> root_node_;
+        Xoshiro128 rng_;
+
+        // O̒T؂stateɈv镔؂Tă[gɂBȂ΍蒼
+        void syncRoot(const State &state)
+        {
+            if (this->root_node_ && !(this->root_node_->state() == state))
+            {
+                std::unique_ptr<Node> next_root_node;
+                for (auto &child_nodes : this->root_node_->child_nodeses)
+                {
+                    for (auto &child_node : child_nodes)
+                    {
+                        if (!next_root_node && child_node && child_node->state() == state)
+                            next_root_node = std::move(child_node);
+                    }
+                }
+                this->root_node_ = std::move(next_root_node);
+            }
+            if (!this->root_node_)
+                this->root_node_ = std::make_unique<Node>(state, SelectionPolicy::UCB1, &this->counter_);
+            if (this->root_node_->child_nodeses.empty())
+                this->root_node_->expand();
+        }
+
+    public:
+        DuctSearcher(const uint64_t seed = mt()) : rng_(seed) {}
+
+        // (ms)w肵DUCTŎw肵vC[̍s肷
+        Action actionWithTimeThreshold(const State &state, const int player_id, const int64_t time_threshold)
+        {
+            this->syncRoot(state);
+            auto time_keeper = TimeKeeper(time_threshold);
+            while (!time_keeper.isTimeOver())
+            {
+                if (this->counter_.needs_recycle_)
+                    this->root_node_->recycle();
+                this->root_node_->evaluate(this->rng_);
+            }
+            return this->root_node_->bestAction(player_id);
+        }
+
+        // Ԃ܂ŎT؂̑傫̏ݒ肷
+        void setNodeBudget(const NodeBudget &budget)
+        {
+            this->counter_.budget_ = budget;
+        }
+
+        // T؂̃gpʂԂ
+        TreeStatistics statistics() const
+        {
+            return this->counter_.statistics_;
+        }
+
+        // ݂̃[gł̎s񐔂Ԃ
+        double rootVisitCount() const
+        {
+            return this->root_node_ ? this->root_node_->n_ : 0;
+        }
+    };
+}
+using ::montecarlo::ductAction;
+using ::montecarlo::ductActionWithTimeThreshold;
+using ::montecarlo::ductActionWithTimeKeeper;
+using ::montecarlo::ductNashAction;
+using ::montecarlo::ductNashActionWithTimeThreshold;
+using ::montecarlo::ductActionWithTimeThresholdParallel;
+using ::montecarlo::DuctSearcher;
+using ::montecarlo::NodeBudget;
+using ::montecarlo::TreeStatistics;
+using ::montecarlo::exp3Action;
+using ::montecarlo::exp3ActionWithTimeThreshold;
+using ::montecarlo::regretMatchingAction;
+using ::montecarlo::regretMatchingActionWithTimeThreshold;
+using ::montecarlo::primitiveMontecarloAction;
+using ::montecarlo::primitiveMontecarloNashAction;
+
+namespace beamsearch
+{
+    // w肵vC[̍sA1^[̎̃XRAőɂȂ×~@Ō肷B胂fƂĎg
+    Action greedyAction(const State &state, const int player_id)
+    {
+        const int opponent_id = (player_id + 1) % 2;
+        const Action opponent_action = state.legalActions(opponent_id)[0];
+        int best_score = -1;
+        Action best_action = -1;
+        for (const auto action : state.legalActions(player_id))
+        {
+            State next_state = state;
+            if (player_id == 0)
+                next_state.advance(action, opponent_action);
+            else
+                next_state.advance(opponent_action, action);
+            if (next_state.gameScore(player_id) > best_score)
+            {
+                best_score = next_state.gameScore(player_id);
+                best_action = action;
+            }
+        }
+        return best_action;
+    }
+
+    // beam̏beam_width̔ՖʂA̍s×~@ŗ\Ď̍sWJ̃r[
+    std::priority_queue<State> nextBeam(std::priority_queue<State> *beam, const int player_id, const int beam_width, const int t)
+    {
+        const int opponent_id = (player_id + 1) % 2;
+        std::priority_queue<State> next_beam;
+        for (int i = 0; i < beam_width; i++)
+        {
+            if (beam->empty())
+                break;
+            State now_state = beam->top();
+            beam->pop();
+            if (now_state.isDone())
+                continue;
+            const Action opponent_action = greedyAction(now_state, opponent_id);
+            for (const auto action : now_state.legalActions(player_id))
+            {
+                State next_state = now_state;
+                if (player_id == 0)
+                    next_state.advance(action, opponent_action);
+                else
+                    next_state.advance(opponent_action, action);
+                next_state.evaluateScore(player_id);
+                if (t == 0)
+                    next_state.first_action_ = action;
+                next_beam.push(next_state);
+            }
+        }
+        return next_beam;
+    }
+
+    // r[Ɛ[w肵āA×~@Ńfr[T[`Ŏw肵vC[̍s肷
+    Action beamSearchAction(const State &state, const int player_id, const int beam_width, const int beam_depth)
+    {
+        std::priority_queue<State> now_beam;
+        State best_state = state;
+
+        now_beam.push(state);
+        for (int t = 0; t < beam_depth; t++)
+        {
+            auto next_beam = nextBeam(&now_beam, player_id, beam_width, t);
+            if (next_beam.empty())
+                break;
+            now_beam = next_beam;
+            best_state = now_beam.top();
+
+            if (best_state.isDone())
+            {
+                break;
+            }
+        }
+        return best_state.first_action_;
+    }
+
+    // time_keeper~߂܂ő×~@Ńfr[T[`ŒTA[Ƃ̍őPprogressɏ
+    Action beamSearchActionWithTimeKeeper(const State &state, const int player_id, const int beam_width, const TimeKeeper &time_keeper, SearchProgress *progress = nullptr)
+    {
+        std::priority_queue<State> now_beam;
+        State best_state = state;
+
+        now_beam.push(state);
+        for (int t = 0;; t++)
+        {
+            auto next_beam = nextBeam(&now_beam, player_id, beam_width, t);
+            if (next_beam.empty())
+                break;
+            now_beam = next_beam;
+            best_state = now_beam.top();
+            if (progress != nullptr)
+                progress->update(best_state.first_action_, t + 1);
+
+            if (best_state.isDone() || time_keeper.isTimeOver())
+            {
+                break;
+            }
+        }
+        return best_state.first_action_;
+    }
+
+    // r[Ɛ(ms)w肵āA×~@Ńfr[T[`Ŏw肵vC[̍s肷
+    Action beamSearchActionWithTimeThreshold(const State &state, const int player_id, const int beam_width, const int64_t time_threshold)
+    {
+        auto time_keeper = TimeKeeper(time_threshold);
+        return beamSearchActionWithTimeKeeper(state, player_id, beam_width, time_keeper);
+    }
+}
+using ::beamsearch::beamSearchAction;
+using ::beamsearch::beamSearchActionWithTimeThreshold;
+using ::beamsearch::beamSearchActionWithTimeKeeper;
+
+// ʃXbhŒTi߁Aro߂̎擾AԐ̕ύXAfłnh
+// Ăяo̓ubNisFinishedbestActionŏ󋵂mFł
+class SearchHandle
+{
+private:
+    TimeKeeper time_keeper_;
+    SearchProgress progress_;
+    std::atomic<bool> is_finished_;
+    std::thread thread_;
+
+public:
+    using SearchFunction = std::function<Action(const TimeKeeper &, SearchProgress *)>;
+
+    // T֐ƎԐ(ms)w肵ĒTJn
+    SearchHandle(const SearchFunction &search, const int64_t time_threshold)
+        : time_keeper_(time_threshold),
+          is_finished_(false)
+    {
+        this->thread_ = std::thread([this, search]()
+                                    {
+            const Action action = search(this->time_keeper_, &this->progress_);
+            if (action >= 0)
+                this->progress_.best_action_ = action;
+            this->is_finished_ = true; });
+    }
+
+    ~SearchHandle()
+    {
+        this->cancel();
+        if (this->thread_.joinable())
+            this->thread_.join();
+    }
+
+    // TI肷
+    bool isFinished() const
+    {
+        return this->is_finished_;
+    }
+
+    // _̍őPԂB܂Ȃ-1
+    Action bestAction() const
+    {
+        return this->progress_.best_action_;
+    }
+
+    // ̐Ԃ
+    int64_t iteration() const
+    {
+        return this->progress_.iteration_;
+    }
+
+    // TJn̎Ԑ(ms)ύX
+    void setTimeThreshold(const int64_t time_threshold)
+    {
+        this->time_keeper_.setTimeThreshold(time_threshold);
+    }
+
+    // T𒆒f
+    void cancel()
+    {
+        this->time_keeper_.cancel();
+    }
+
+    // T̏I҂čőPԂ
+    Action wait()
+    {
+        if (this->thread_.joinable())
+            this->thread_.join();
+        return this->bestAction();
+    }
+};
+
+// Ԑ(ms)w肵DUCTŎw肵vC[̔񓯊TJn
+std::unique_ptr<SearchHandle> startDuctSearch(const State &state, const int player_id, const int64_t time_threshold)
+{
+    return std::make_unique<SearchHandle>([state, player_id](const TimeKeeper &time_keeper, SearchProgress *progress)
+                                          { return ductActionWithTimeKeeper(state, player_id, time_keeper, progress); },
+                                          time_threshold);
+}
+
+// r[ƎԐ(ms)w肵ăr[T[`Ŏw肵vC[̔񓯊TJn
+std::unique_ptr<SearchHandle> startBeamSearch(const State &state, const int player_id, const int beam_width, const int64_t time_threshold)
+{
+    return std::make_unique<SearchHandle>([state, player_id, beam_width](const TimeKeeper &time_keeper, SearchProgress *progress)
+                                          { return beamSearchActionWithTimeKeeper(state, player_id, beam_width, time_keeper, progress); },
+                                          time_threshold);
+}
+
+// ȑΐŊwKf[^
+// t@C̓wb_̌Ƀ`NǋLĂ`ŁA`N͋ǖʂƂ̋L^l߂
+// `N͏IĂ܂Ƃ߂ĒǋL̂ŁArŎ~܂Ẵ`Nǂݔ΂ΉȂ
+namespace selfplay
+{
+    constexpr const char FILE_MAGIC[8] = "SPDATA1"; // t@C`̎ʎq
+    constexpr const uint32_t CHUNK_MAGIC = 0x4b4e4843; // "CHNK"
+    constexpr const size_t CHUNK_BYTE_SIZE = 1 << 20; // `Nt@Cɏo傫̖ڈ
+
+    // t@C̐擪ɒuwb_
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t game_id; // ǂ̃Q[̃f[^
+        uint32_t reserved;
+    };
+
+    // `N̐擪ɒuwb_
+    struct ChunkHeader
+    {
+        uint32_t magic;
+        uint32_t record_number;
+        uint64_t byte_size; // ̃wb_`N̑傫
+    };
+
+    // 1ǖʕ̋L^̐擪ɒuwb_
+    // ɍs(int32_t)A(float)AՖ(oCgA4oCgE܂ŋlߕ)
+    struct RecordHeader
+    {
+        uint32_t game_index; // ǖڂ
+        uint32_t state_size; // Ֆʂ̃oCg
+        uint16_t ply; // ڂ
+        uint16_t policy_size; // ̗vf
+        uint8_t action_number; // L^s̐
+        uint8_t reserved[3];
+        float outcome; // ŏI
+    };
+
+    // L^1̃oCgԂ
+    size_t recordByteSize(const RecordHeader &header)
+    {
+        return sizeof(RecordHeader) + header.action_number * sizeof(int32_t) + header.policy_size * sizeof(float) + (header.state_size + 3) / 4 * 4;
+    }
+
+    // ̃Xbh`NPʂŒǋLt@C
+    class Writer
+    {
+    private:
+        std::ofstream ofs_;
+        std::mutex mutex_;
+
+    public:
+        // t@CǋLpɊJAȂwb_
+        Writer(const std::string &path, const uint32_t game_id)
+            : ofs_(path, std::ios::binary | std::ios::app)
+        {
+            if (!this->ofs_)
+                throw std::string("cannot open ") + path;
+            this->ofs_.seekp(0, std::ios::end);
+            if (this->ofs_.tellp() == 0)
+            {
+                FileHeader header{};
+                std::memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+                header.game_id = game_id;
+                this->ofs_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                this->ofs_.flush();
+            }
+        }
+
+        // L^l߂oCg1̃`NƂĒǋL
+        void appendChunk(const std::vector<uint8_t> &records, const uint32_t record_number)
+        {
+            ChunkHeader header{CHUNK_MAGIC, record_number, records.size()};
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->ofs_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            this->ofs_.write(reinterpret_cast<const char*>(records.data()), records.size());
+            this->ofs_.flush();
+        }
+    };
+
+    // XbhƂɋL^𗭂߁Ȃ傫ɂȂWriterɃ`NƂēn
+    class ChunkBuffer
+    {
+    private:
+        Writer *writer_;
+        std::vector<uint8_t> bytes_;
+        uint32_t record_number_;
+
+    public:
+        explicit ChunkBuffer(Writer *writer)
+            : writer_(writer),
+              record_number_(0)
+        {
+            this->bytes_.reserve(CHUNK_BYTE_SIZE * 2);
+        }
+
+        ~ChunkBuffer()
+        {
+            this->flush();
+        }
+
+        // 1ǖʕ̋L^ǉ
+        void addRecord(const RecordHeader &header, const int32_t *actions, const float *policy, const uint8_t *state)
+        {
+            const size_t offset = this->bytes_.size();
+            this->bytes_.resize(offset + recordByteSize(header));
+            uint8_t *p = this->bytes_.data() + offset;
+            std::memcpy(p, &header, sizeof(header));
+            p += sizeof(header);
+            std::memcpy(p, actions, header.action_number * sizeof(int32_t));
+            p += header.action_number * sizeof(int32_t);
+            std::memcpy(p, policy, header.policy_size * sizeof(float));
+            p += header.policy_size * sizeof(float);
+            std::memcpy(p, state, header.state_size);
+            this->record_number_++;
+            if (this->bytes_.size() >= CHUNK_BYTE_SIZE)
+                this->flush();
+        }
+
+        // ܂ĂL^o
+        void flush()
+        {
+            if (this->record_number_ == 0)
+                return;
+            this->writer_->appendChunk(this->bytes_, this->record_number_);
+            this->bytes_.clear();
+            this->record_number_ = 0;
+        }
+    };
+
+    // L^1At@C̃f[^w܂ܓǂނ߂̃r[
+    struct Record
+    {
+        RecordHeader header;
+        const int32_t *actions;
+        const float *policy;
+        const uint8_t *state;
+    };
+
+    // wKf[^̃t@C}bvēǂށB}bvłȂł̓t@CŜǂݍ
+    class Reader
+    {
+    private:
+        const uint8_t *data_;
+        size_t size_;
+        void *mapped_;
+        std::vector<uint8_t> buffer_;
+        FileHeader header_;
+
+    public:
+        // RXgN^O𓊂ƃfXgN^͌Ă΂Ȃ̂ŁA؂I܂łmmap̈[JϐŎ
+        explicit Reader(const std::string &path)
+            : data_(nullptr),
+              size_(0),
+              mapped_(nullptr)
+        {
+            void *mapped = nullptr;
+            const uint8_t *data = nullptr;
+            size_t size = 0;
+#ifndef _WIN32
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::string("cannot open ") + path;
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0)
+            {
+                void *result = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                if (result != MAP_FAILED)
+                {
+                    mapped = result;
+                    data = static_cast<const uint8_t*>(result);
+                    size = st.st_size;
+                }
+            }
+            close(fd);
+#endif
+            if (data == nullptr)
+            {
+                std::ifstream ifs(path, std::ios::binary);
+                if (!ifs)
+                    throw std::string("cannot open ") + path;
+                this->buffer_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+                data = this->buffer_.data();
+                size = this->buffer_.size();
+            }
+            // ꂽt@CȂAmmap̈ĂO𓊂
+            const auto broken = [&]()
+            {
+#ifndef _WIN32
+                if (mapped != nullptr)
+                    munmap(mapped, size);
+#endif
+                return std::string("broken self-play data ") + path;
+            };
+            if (size < sizeof(FileHeader))
+                throw broken();
+            std::memcpy(&this->header_, data, sizeof(FileHeader));
+            if (std::memcmp(this->header_.magic, FILE_MAGIC, sizeof(this->header_.magic)) != 0)
+                throw broken();
+            this->mapped_ = mapped;
+            this->data_ = data;
+            this->size_ = size;
+        }
+
+        Reader(const Reader&) = delete;
+        Reader &operator=(const Reader&) = delete;
+
+        ~Reader()
+        {
+#ifndef _WIN32
+            if (this->mapped_ != nullptr)
+                munmap(this->mapped_, this->size_);
+#endif
+        }
+
+        // ǂ̃Q[̃f[^Ԃ
+        uint32_t gameId() const
+        {
+            return this->header_.game_id;
+        }
+
+        // SĂ̋L^擪珇callbackɓnAL^̐ԂB̃`N͓ǂ܂Ȃ
+        int64_t forEachRecord(const std::function<void(const Record&)> &callback) const
+        {
+            int64_t record_number = 0;
+            size_t offset = sizeof(FileHeader);
+            while (offset + sizeof(ChunkHeader) <= this->size_)
+            {
+                ChunkHeader chunk;
+                std::memcpy(&chunk, this->data_ + offset, sizeof(chunk));
+                offset += sizeof(chunk);
+                if (chunk.magic != CHUNK_MAGIC || offset + chunk.byte_size > this->size_)
+                    break;
+                const uint8_t *p = this->data_ + offset;
+                for (uint32_t i = 0; i < chunk.record_number; i++)
+                {
+                    Record record;
+                    std::memcpy(&record.header, p, sizeof(record.header));
+                    record.actions = reinterpret_cast<const int32_t*>(p + sizeof(RecordHeader));
+                    record.policy = reinterpret_cast<const float*>(record.actions + record.header.action_number);
+                    record.state = reinterpret_cast<const uint8_t*>(record.policy + record.header.policy_size);
+                    callback(record);
+                    p += recordByteSize(record.header);
+                    record_number++;
+                }
+                offset += chunk.byte_size;
+            }
+            return record_number;
+        }
+    };
+
+    constexpr const uint32_t GAME_ID = 2; // lQ[̃f[^
+
+    // 1ǂȑΐ킵AǖʂƂ̔ՖʁAvC[I񂾍sADUCT̗vC[̎s񐔂̕zAvC[0猩ŏIʂL^
+    void playSelfPlayGame(const uint32_t game_index, const State &initial_state, const int playout_number, Xoshiro128 &rng, ChunkBuffer *buffer)
+    {
+        struct Position
+        {
+            State state;
+            int32_t actions[2];
+            float policy[2 * State::MAX_ACTION_NUMBER]; // [vC[][s]
+        };
+        std::vector<Position> positions;
+        auto state = initial_state;
+        while (!state.isDone())
+        {
+            Position position{state, {-1, -1}, {}};
+            montecarlo::Node root_node = montecarlo::Node(state);
+            root_node.expand();
+            for (int i = 0; i < playout_number; i++)
+            {
+                root_node.evaluate(rng);
+            }
+            for (int player_id = 0; player_id < 2; player_id++)
+            {
+                const auto &legal_actions = root_node.legalActions(player_id);
+                const auto &action_counts = root_node.actionCounts(player_id);
+                double total = 0;
+                for (const auto count : action_counts)
+                {
+                    total += count;
+                }
+                for (int i = 0; i < (int)legal_actions.size(); i++)
+                {
+                    position.policy[player_id * State::MAX_ACTION_NUMBER + legal_actions[i]] = total > 0 ? (float)(action_counts[i] / total) : 0.f;
+                }
+                position.actions[player_id] = root_node.bestAction(player_id);
+            }
+            positions.emplace_back(position);
+            state.advance(position.actions[0], position.actions[1]);
+        }
+        const double first_player_score = state.getFirstPlayerScoreForWinRate();
+        std::vector<uint8_t> encoded;
+        for (int ply = 0; ply < (int)positions.size(); ply++)
+        {
+            const auto &position = positions[ply];
+            encoded.resize(position.state.encodedSize());
+            position.state.encode(encoded.data());
+            RecordHeader header{};
+            header.game_index = game_index;
+            header.state_size = (uint32_t)encoded.size();
+            header.ply = (uint16_t)ply;
+            header.policy_size = 2 * State::MAX_ACTION_NUMBER;
+            header.action_number = 2;
+            header.outcome = (float)first_player_score;
+            buffer->addRecord(header, position.actions, position.policy, encoded.data());
+        }
+    }
+
+    // Xbh1̎ȑΐBSXbhŋLԍȂgame_numberǂ܂őΐ킷
+    void selfPlayWorker(Writer *writer, std::atomic<uint32_t> *next_game_index, const uint32_t game_number, const int playout_number, const uint64_t seed)
+    {
+        Xoshiro128 rng(seed);
+        ChunkBuffer buffer(writer);
+        for (uint32_t game_index = (*next_game_index)++; game_index < game_number; game_index = (*next_game_index)++)
+        {
+            playSelfPlayGame(game_index, State(5, 5, (int)rng()), playout_number, rng, &buffer);
+        }
+    }
+
+    // 1肠̃vCAEgƃXbhw肵game_numberǂȑΐ킵AwKf[^path̃t@CɒǋL
+    void runSelfPlay(const std::string &path, const uint32_t game_number, const int playout_number, const int thread_number)
+    {
+        Writer writer(path, GAME_ID);
+        std::atomic<uint32_t> next_game_index(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < thread_number; t++)
+        {
+            threads.emplace_back(selfPlayWorker, &writer, &next_game_index, game_number, playout_number, (uint64_t)mt());
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
+using ::selfplay::runSelfPlay;
+
+// Ht@C̓ǂݏ
+// 傫ȖH̃x`}[N𓯂ŌJԂ悤AHt@CɌŒ肵Aǂݍ݂mmapōs
+namespace mazefile
+{
+    constexpr const char MAGIC[8] = "MAZE001";
+    constexpr const int MAX_CHARACTER_NUMBER = 2; // lQ[ƓlQ[œ`g
+    constexpr const int CHARACTER_NUMBER = 2;     // ̃Q[̃LN^[
+    constexpr const char *EXTENSION = ".maze";
+
+    // t@C̐擪ɒuwb_Bĕǂh*woCgA|Cgh*woCgׂ
+    struct Header
+    {
+        char magic[8];
+        int32_t h;
+        int32_t w;
+        int32_t end_turn;
+        int32_t character_number;
+        int32_t characters[MAX_CHARACTER_NUMBER][2]; // eLN^[̏(y,x)
+    };
+
+    // Hpath̃t@Cɏo
+    void write(const std::string &path, const MazeBoard &board)
+    {
+        Header header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.h = board.h_;
+        header.w = board.w_;
+        header.end_turn = board.end_turn_;
+        header.character_number = CHARACTER_NUMBER;
+        for (int player_id = 0; player_id < CHARACTER_NUMBER; player_id++)
+        {
+            header.characters[player_id][0] = board.start_y_[player_id];
+            header.characters[player_id][1] = board.start_x_[player_id];
+        }
+        std::ofstream ofs(path, std::ios::binary);
+        if (!ofs)
+            throw std::string("cannot open ") + path;
+        const size_t area = (size_t)board.h_ * board.w_;
+        ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        ofs.write(reinterpret_cast<const char *>(board.walls_), area);
+        ofs.write(reinterpret_cast<const char *>(board.points_), area);
+        if (!ofs)
+            throw std::string("cannot write ") + path;
+    }
+
+    // path̖Ht@CǂݍށBǂƏ|Cgmmap̈̂܂܎QƂ
+    std::shared_ptr<const MazeBoard> load(const std::string &path)
+    {
+        auto board = std::make_shared<MazeBoard>();
+        const uint8_t *data = nullptr;
+        size_t size = 0;
+#ifndef _WIN32
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::string("cannot open ") + path;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            const size_t mapped_size = st.st_size;
+            void *mapped = mmap(nullptr, mapped_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                board->mapping_ = std::shared_ptr<const void>(mapped, [mapped_size](const void *p)
+                                                              { munmap(const_cast<void *>(p), mapped_size); });
+                data = static_cast<const uint8_t *>(mapped);
+                size = mapped_size;
+            }
+        }
+        close(fd);
+#endif
+        if (data == nullptr)
+        {
+            std::ifstream ifs(path, std::ios::binary);
+            if (!ifs)
+                throw std::string("cannot open ") + path;
+            board->buffer_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+            data = board->buffer_.data();
+            size = board->buffer_.size();
+        }
+
+        Header header;
+        if (size < sizeof(header))
+            throw std::string("broken maze file ") + path;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0 || header.h <= 0 || header.w <= 0 || header.end_turn < 0 || size != sizeof(header) + 2 * (size_t)header.h * header.w)
+            throw std::string("broken maze file ") + path;
+        if (header.character_number != CHARACTER_NUMBER)
+            throw std::string("maze file for another game ") + path;
+        board->h_ = header.h;
+        board->w_ = header.w;
+        board->end_turn_ = header.end_turn;
+        board->walls_ = data + sizeof(header);
+        board->points_ = board->walls_ + (size_t)header.h * header.w;
+        for (int player_id = 0; player_id < CHARACTER_NUMBER; player_id++)
+        {
+            const int y = header.characters[player_id][0];
+            const int x = header.characters[player_id][1];
+            if (y < 0 || y >= board->h_ || x < 0 || x >= board->w_ || board->walls_[y * board->w_ + x])
+                throw std::string("broken maze file ") + path;
+            board->start_y_[player_id] = y;
+            board->start_x_[player_id] = x;
+        }
+        return board;
+    }
+
+    // directoryɂHt@CAt@CɑSēǂݍ
+    std::vector<std::shared_ptr<const MazeBoard>> loadDirectory(const std::string &directory)
+    {
+        std::vector<std::string> paths;
+        for (const auto &entry : std::filesystem::directory_iterator(directory))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == EXTENSION)
+            {
+                paths.emplace_back(entry.path().string());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+        std::vector<std::shared_ptr<const MazeBoard>> boards;
+        for (const auto &path : paths)
+        {
+            boards.emplace_back(load(path));
+        }
+        return boards;
+    }
+
+    // V[h0~number-1Őh*w̖HAdirectoryɖHt@CƂďo
+    void generateDirectory(const std::string &directory, const int number, const int h, const int w)
+    {
+        std::filesystem::create_directories(directory);
+        for (int seed = 0; seed < number; seed++)
+        {
+            std::string name = std::to_string(seed);
+            name = std::string(name.size() < 6 ? 6 - name.size() : 0, '0') + name;
+            write((std::filesystem::path(directory) / (name + EXTENSION)).string(), *State(h, w, seed).board());
+        }
+    }
+}
+
+#ifndef _WIN32
+// ̃vZXő΋ǂ𕪒S
+// R[fBl[^[UnixhC\Pbgő҂󂯁AڑĂ[J[1ǂdnČʂ󂯎
+// ʂ1ǂƂɒǋL̂ŁAR[fBl[^[⃏[J[~܂ĂI΋ǂ͎Ȃ
+// ḾuREADYvuGAME  ݒ V[hvuRESULT  ʁvuDONEv1s̃eLXgōs
+namespace farm
+{
+    constexpr const int POLL_INTERVAL = 100; // ҂󂯂̊Ԋu(ms)
+    constexpr const int CONNECT_RETRY_NUMBER = 100; // [J[R[fBl[^[̋N҂
+
+    // 1Ǖ̎dBconfigurationԖڂ̐ݒŁAseedՖʂ1ǃvC
+    struct Task
+    {
+        int game_index;
+        int configuration;
+        uint32_t seed;
+    };
 
-    // (ms)w肵DUCTŎw肵vC[̍s肷
-    Action ductAction(const State &state, const int player_id, const int playout_number)
+    // game_indexǖڂ̎dԂBSĂ̐ݒ肪V[hɃvC悤U
+    Task taskOf(const int game_index, const int configuration_number)
     {
-        Node root_node = Node(state);
-        root_node.expand();
-        for (int i = 0; i < playout_number; i++)
+        return Task{game_index, game_index % configuration_number, (uint32_t)(game_index / configuration_number)};
+    }
+
+    // 1sBȂfalseԂ
+    bool sendLine(const int fd, const std::string &line)
+    {
+        const std::string data = line + "\n";
+        size_t sent = 0;
+        while (sent < data.size())
         {
-            root_node.evaluate();
+            const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return false;
+            sent += n;
         }
-        auto legal_actions = state.legalActions(player_id);
-        int i_size = root_node.child_nodeses.size();
-        int j_size = root_node.child_nodeses[0].size();
+        return true;
+    }
+
+    // Mf[^bufferɒǋLBؒfꂽfalseԂ
+    bool receive(const int fd, std::string *buffer)
+    {
+        char data[4096];
+        const ssize_t n = recv(fd, data, sizeof(data), 0);
+        if (n < 0 && errno == EINTR)
+            return true;
+        if (n <= 0)
+            return false;
+        buffer->append(data, n);
+        return true;
+    }
+
+    // buffer1soB܂1sĂȂfalseԂ
+    bool popLine(std::string *buffer, std::string *line)
+    {
+        const size_t position = buffer->find('\n');
+        if (position == std::string::npos)
+            return false;
+        *line = buffer->substr(0, position);
+        buffer->erase(0, position + 1);
+        return true;
+    }
+
+    // pathUnixhC\Pbg̃AhXԂ
+    sockaddr_un socketAddress(const std::string &path)
+    {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+            throw std::string("socket path too long ") + path;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return address;
+    }
 
-        if (player_id == 0)
+    // [J[ɎdzAʂt@CɒǋLR[fBl[^[
+    // ʃt@Ću ݒ V[h ʁv̍s̕тŁAʂ̐擪̓XRAɂ
+    // NɌʃt@Cǂ݁AIĂǂ͔zȂ
+    class Coordinator
+    {
+    private:
+        struct Worker
         {
-            int best_n = -1;
-            int best_i = -1;
-            for (int i = 0; i < i_size; i++)
+            int fd;
+            std::string buffer;
+            bool is_waiting; // d҂Ă邩
+            int game_index; // S̋ǁBȂ-1
+        };
+
+        std::string socket_path_;
+        int listen_fd_;
+        int game_number_;
+        int configuration_number_;
+        std::ofstream result_stream_;
+        std::vector<uint8_t> is_done_;
+        int done_number_;
+        std::deque<int> pending_; // ܂NɂnĂȂ
+        std::vector<Worker> workers_;
+        std::vector<double> score_sums_; // ݒ育Ƃ̃XRA̘a
+        std::vector<int> score_counts_; // ݒ育Ƃ̏Iǐ
+
+        // ʂ1sǂݍŏWvAWvłԂBꂽsdǂ͖
+        bool load(const std::string &line)
+        {
+            std::istringstream iss(line);
+            int game_index, configuration;
+            uint32_t seed;
+            double score;
+            if (!(iss >> game_index >> configuration >> seed >> score))
+                return false;
+            if (game_index < 0 || game_index >= this->game_number_ || this->is_done_[game_index])
+                return false;
+            const Task task = taskOf(game_index, this->configuration_number_);
+            if (task.configuration != configuration || task.seed != seed)
+                return false;
+            this->is_done_[game_index] = 1;
+            ++this->done_number_;
+            this->score_sums_[configuration] += score;
+            ++this->score_counts_[configuration];
+            return true;
+        }
+
+        // ҂Ă郏[J[Ɏ̋ǂnBSďIĂΏI`
+        bool assign(Worker *worker)
+        {
+            if (this->pending_.empty())
             {
-                int n = 0;
-                for (int j = 0; j < j_size; j++)
-                {
-                    n += root_node.child_nodeses[i][j].n_;
-                }
-                // std::cout << dstr[legal_actions[i]] << " " << n << std::endl;
-                if (n > best_n)
-                {
-                    best_i = i;
-                    best_n = n;
-                }
+                if (!this->isFinished())
+                    return true; // ̃[J[S̋ǂ߂Ă邩Ȃ̂ő҂
+                worker->is_waiting = false;
+                return sendLine(worker->fd, "DONE");
             }
-            // std::cout <<"best\t" << dstr[legal_actions[best_i]] << " " << best_n << std::endl;
+            const Task task = taskOf(this->pending_.front(), this->configuration_number_);
+            this->pending_.pop_front();
+            worker->is_waiting = false;
+            worker->game_index = task.game_index;
+            return sendLine(worker->fd, "GAME " + std::to_string(task.game_index) + " " + std::to_string(task.configuration) + " " + std::to_string(task.seed));
+        }
 
-            return legal_actions[best_i];
+        // [J[󂯎1sBڑ؂ׂȂfalseԂ
+        bool handle(Worker *worker, const std::string &line)
+        {
+            std::istringstream iss(line);
+            std::string command;
+            iss >> command;
+            if (command == "READY")
+            {
+                worker->is_waiting = true;
+                return this->assign(worker);
+            }
+            if (command != "RESULT")
+                return false;
+            int game_index;
+            if (!(iss >> game_index) || game_index < 0 || game_index >= this->game_number_)
+                return false;
+            if (game_index == worker->game_index)
+            {
+                worker->game_index = -1;
+                worker->is_waiting = true;
+            }
+            else if (!this->is_done_[game_index])
+                return false; // nĂȂǂ̌
+            // z蒼ǂ𑼂̃[J[ɏIĂꍇ́Aʂ̂ĂĐڑ͂̂܂܎g
+            if (!this->is_done_[game_index])
+            {
+                std::string result;
+                std::getline(iss >> std::ws, result);
+                const Task task = taskOf(game_index, this->configuration_number_);
+                const std::string record = std::to_string(task.game_index) + " " + std::to_string(task.configuration) + " " + std::to_string(task.seed) + " " + result;
+                if (!this->load(record))
+                    return false;
+                this->result_stream_ << record << std::endl;
+            }
+            return worker->is_waiting ? this->assign(worker) : true;
         }
-        else
+
+        // ҂sɂڑSĎ󂯕t
+        void acceptAll()
         {
-            int best_n = -1;
-            int best_j = -1;
-            for (int j = 0; j < j_size; j++)
+            int fd;
+            while ((fd = accept(this->listen_fd_, nullptr, nullptr)) >= 0)
+            {
+                this->workers_.emplace_back(Worker{fd, "", false, -1});
+            }
+        }
+
+        // ڑAS̋ǂΔz蒼
+        void drop(Worker *worker)
+        {
+            close(worker->fd);
+            worker->fd = -1;
+            if (worker->game_index >= 0 && !this->is_done_[worker->game_index])
+                this->pending_.push_front(worker->game_index);
+        }
+
+    public:
+        Coordinator(const std::string &socket_path, const std::string &result_path, const int game_number, const int configuration_number) : socket_path_(socket_path), listen_fd_(-1), game_number_(game_number), configuration_number_(configuration_number), is_done_(game_number, 0), done_number_(0), score_sums_(configuration_number, 0), score_counts_(configuration_number, 0)
+        {
+            bool ends_with_newline = true;
+            off_t complete_size = 0; // sŏIĂs܂ł̃oCg
             {
-                int n = 0;
-                for (int i = 0; i < i_size; i++)
+                std::ifstream ifs(result_path);
+                std::string line;
+                while (std::getline(ifs, line))
                 {
-                    n += root_node.child_nodeses[i][j].n_;
+                    if (ifs.eof())
+                    {
+                        ends_with_newline = false;
+                        break;
+                    }
+                    this->load(line);
+                    complete_size += line.size() + 1;
                 }
-                if (n > best_n)
+            }
+            if (!ends_with_newline && truncate(result_path.c_str(), complete_size) != 0) // Ŏ~܂Ō̍ŝ͎Ă
+                throw std::string("cannot truncate ") + result_path;
+            this->result_stream_.open(result_path, std::ios::app);
+            if (!this->result_stream_)
+                throw std::string("cannot open ") + result_path;
+            for (int game_index = 0; game_index < game_number; game_index++)
+            {
+                if (!this->is_done_[game_index])
+                    this->pending_.emplace_back(game_index);
+            }
+
+            const auto address = socketAddress(socket_path);
+            unlink(socket_path.c_str());
+            this->listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (this->listen_fd_ < 0
+                || bind(this->listen_fd_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0
+                || listen(this->listen_fd_, SOMAXCONN) != 0
+                || fcntl(this->listen_fd_, F_SETFL, O_NONBLOCK) != 0) // ڑėĂ1̑҂󂯂ł܂Ƃ߂Ď󂯕t悤ɂ
+                throw std::string("cannot listen on ") + socket_path;
+        }
+
+        Coordinator(const Coordinator &) = delete;
+        Coordinator &operator=(const Coordinator &) = delete;
+
+        ~Coordinator()
+        {
+            this->shutdown();
+        }
+
+        // SĂ̋ǂI肷
+        bool isFinished() const
+        {
+            return this->done_number_ == this->game_number_;
+        }
+
+        // IǐԂ
+        int doneNumber() const
+        {
+            return this->done_number_;
+        }
+
+        // őtimeout(ms)҂āAڑ̎󂯕tƌʂ̎󂯎
+        void step(const int timeout)
+        {
+            std::vector<pollfd> fds = {pollfd{this->listen_fd_, POLLIN, 0}};
+            for (const auto &worker : this->workers_)
+            {
+                fds.emplace_back(pollfd{worker.fd, POLLIN, 0});
+            }
+            if (poll(fds.data(), fds.size(), timeout) < 0)
+                return;
+            for (int i = 0; i < (int)this->workers_.size(); i++)
+            {
+                auto &worker = this->workers_[i];
+                if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)))
+                    continue;
+                bool is_alive = receive(worker.fd, &worker.buffer);
+                std::string line;
+                while (is_alive && popLine(&worker.buffer, &line))
                 {
-                    best_j = j;
-                    best_n = n;
+                    is_alive = this->handle(&worker, line);
                 }
+                if (!is_alive)
+                    this->drop(&worker);
+            }
+            this->workers_.erase(std::remove_if(this->workers_.begin(), this->workers_.end(), [](const Worker &worker) { return worker.fd < 0; }), this->workers_.end());
+            if (fds[0].revents & POLLIN)
+                this->acceptAll();
+            // z蒼ɂȂǂ҂Ă郏[J[ɓn
+            for (auto &worker : this->workers_)
+            {
+                if (worker.is_waiting && !this->assign(&worker))
+                    this->drop(&worker);
             }
-            return legal_actions[best_j];
+            this->workers_.erase(std::remove_if(this->workers_.begin(), this->workers_.end(), [](const Worker &worker) { return worker.fd < 0; }), this->workers_.end());
         }
-    }
 
-    // (ms)w肵DUCTŎw肵vC[̍s肷
-    Action ductActionWithTimeThreshold(const State &state, const int player_id, const int64_t time_threshold)
-    {
-        Node root_node = Node(state);
-        root_node.expand();
-        auto time_keeper = TimeKeeper(time_threshold);
-        for (int cnt = 0;; cnt++)
+        // ҂󂯂߁AڑƐڑ҂̃[J[SĂɏI`ă\Pbg
+        // IɃ[J[̏I҂Ƃ́AɂĂő҂郏[J[cȂ悤ɂ
+        void shutdown()
         {
-            if (time_keeper.isTimeOver())
+            if (this->listen_fd_ < 0)
+                return;
+            this->acceptAll();
+            for (auto &worker : this->workers_)
             {
-                break;
+                if (worker.fd >= 0)
+                    sendLine(worker.fd, "DONE");
             }
-            root_node.evaluate();
+            this->releaseSockets();
+            unlink(this->socket_path_.c_str());
         }
-        auto legal_actions = state.legalActions(player_id);
-        int i_size = root_node.child_nodeses.size();
-        int j_size = root_node.child_nodeses[0].size();
 
-        if (player_id == 0)
+        // \PbgSĕBforkqvZXł͈p\Pbgŕ
+        void releaseSockets()
         {
-            int best_n = -1;
-            int best_i = -1;
-            for (int i = 0; i < i_size; i++)
+            for (auto &worker : this->workers_)
             {
-                int n = 0;
-                for (int j = 0; j < j_size; j++)
-                {
-                    n += root_node.child_nodeses[i][j].n_;
-                }
-                // std::cout << dstr[legal_actions[i]] << " " << n << std::endl;
-                if (n > best_n)
-                {
-                    best_i = i;
-                    best_n = n;
-                }
+                if (worker.fd >= 0)
+                    close(worker.fd);
+                worker.fd = -1;
+            }
+            this->workers_.clear();
+            if (this->listen_fd_ >= 0)
+                close(this->listen_fd_);
+            this->listen_fd_ = -1;
+        }
+
+        // ݒ育Ƃ̕σXRA𕶎ɂ
+        std::string summary() const
+        {
+            std::stringstream ss;
+            for (int configuration = 0; configuration < this->configuration_number_; configuration++)
+            {
+                const int count = this->score_counts_[configuration];
+                ss << "Score of configuration " << configuration << ":\t" << (count > 0 ? this->score_sums_[configuration] / count : 0.) << " (" << count << " games)\n";
             }
-            // std::cout <<"best\t" << dstr[legal_actions[best_i]] << " " << best_n << std::endl;
+            return ss.str();
+        }
+    };
 
-            return legal_actions[best_i];
+    // R[fBl[^[ɐڑAnꂽdplay_gameŃvCČʂԂBI`邩ؒfꂽ߂
+    void runWorker(const std::string &socket_path, const std::function<std::string(const Task &)> &play_game)
+    {
+        const auto address = socketAddress(socket_path);
+        int fd = -1;
+        for (int retry = 0;; retry++)
+        {
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0)
+                break;
+            if (fd >= 0)
+                close(fd);
+            if (retry >= CONNECT_RETRY_NUMBER)
+                throw std::string("cannot connect to ") + socket_path;
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL));
         }
-        else
+        std::string buffer, line;
+        if (sendLine(fd, "READY"))
         {
-            int best_n = -1;
-            int best_j = -1;
-            for (int j = 0; j < j_size; j++)
+            while (true)
             {
-                int n = 0;
-                for (int i = 0; i < i_size; i++)
-                {
-                    n += root_node.child_nodeses[i][j].n_;
-                }
-                if (n > best_n)
+                while (!popLine(&buffer, &line))
                 {
-                    best_j = j;
-                    best_n = n;
+                    if (!receive(fd, &buffer))
+                    {
+                        close(fd);
+                        return;
+                    }
                 }
+                std::istringstream iss(line);
+                std::string command;
+                Task task;
+                iss >> command;
+                if (command != "GAME" || !(iss >> task.game_index >> task.configuration >> task.seed))
+                    break;
+                if (!sendLine(fd, "RESULT " + std::to_string(task.game_index) + " " + play_game(task)))
+                    break;
             }
-            return legal_actions[best_j];
         }
+        close(fd);
     }
-
 }
-using ::montecarlo::ductAction;
-using ::montecarlo::ductActionWithTimeThreshold;
-using ::montecarlo::primitiveMontecarloAction;
+#endif
+
+
 
 #include <iostream>
 #include <functional>
@@ -573,22 +2452,330 @@ using ::montecarlo::primitiveMontecarloAction;
 using AIFunction = std::function<Action(const State &, const int)>;
 using StringAIPair = std::pair<std::string, AIFunction>;
 // Q[1vCăQ[󋵂\
-void playGame(const std::vector<StringAIPair> &ais)
+// prints_boardfalseȂ疈^[̔Ֆʂ̕񉻂ȂAsƍŌ̔Ֆʂ\
+void playGame(const std::vector<StringAIPair> &ais, const bool prints_board = true)
 {
     using std::cout;
     using std::endl;
 
     auto state = State(5, 5, mt());
-    cout << state.toString() << endl;
+    if (prints_board)
+        cout << state.toString() << endl;
 
     while (!state.isDone())
     {
         std::vector<Action> actions = {ais[0].second(state, 0), ais[1].second(state, 1)};
         cout << "actions " << dstr[actions[0]] << " " << dstr[actions[1]] << endl;
         state.advance(actions[0], actions[1]);
+        if (prints_board)
+            cout << state.toString() << endl;
+    }
+    if (!prints_board)
         cout << state.toString() << endl;
+}
+
+// BՖʂ̑傫ƃV[hAvC[̍s̗ƎvlԂAՖʂreplayō蒼
+struct GameRecord
+{
+    int h = 0;
+    int w = 0;
+    int seed = 0;
+    std::vector<std::array<Action, 2>> actions;
+    std::vector<std::array<int64_t, 2>> microseconds; // sƂ̎vl(s)
+
+    // u  V[h ^[ s... vl...v1sŏo
+    void write(std::ostream &os) const
+    {
+        os << this->h << ' ' << this->w << ' ' << this->seed << ' ' << this->actions.size();
+        for (const auto &action : this->actions)
+            os << ' ' << action[0] << ' ' << action[1];
+        for (const auto &microsecond : this->microseconds)
+            os << ' ' << microsecond[0] << ' ' << microsecond[1];
+        os << '\n';
+    }
+
+    // writeŏ1sǂݍށBǂ߂ȂfalseԂ
+    bool read(std::istream &is)
+    {
+        size_t turn_number;
+        if (!(is >> this->h >> this->w >> this->seed >> turn_number))
+            return false;
+        this->actions.resize(turn_number);
+        this->microseconds.resize(turn_number);
+        for (auto &action : this->actions)
+            is >> action[0] >> action[1];
+        for (auto &microsecond : this->microseconds)
+            is >> microsecond[0] >> microsecond[1];
+        return (bool)is;
+    }
+
+    // turn^[ڂ܂Ői߂Ֆʂ蒼
+    State replay(const int turn) const
+    {
+        auto state = State(this->h, this->w, this->seed);
+        for (int i = 0; i < turn && i < (int)this->actions.size(); i++)
+        {
+            state.advance(this->actions[i][0], this->actions[i][1]);
+        }
+        return state;
+    }
+};
+
+// Q[1vCĊԂBՖʂ̕\͂Ȃ
+GameRecord recordGame(const std::vector<StringAIPair> &ais, const int h, const int w, const int seed)
+{
+    GameRecord record;
+    record.h = h;
+    record.w = w;
+    record.seed = seed;
+    auto state = State(h, w, seed);
+    while (!state.isDone())
+    {
+        std::array<Action, 2> actions;
+        std::array<int64_t, 2> microseconds;
+        for (int player_id = 0; player_id < 2; player_id++)
+        {
+            const auto start_time = std::chrono::high_resolution_clock::now();
+            actions[player_id] = ais[player_id].second(state, player_id);
+            const auto diff = std::chrono::high_resolution_clock::now() - start_time;
+            microseconds[player_id] = std::chrono::duration_cast<std::chrono::microseconds>(diff).count();
+        }
+        record.actions.emplace_back(actions);
+        record.microseconds.emplace_back(microseconds);
+        state.advance(actions[0], actions[1]);
+    }
+    return record;
+}
+
+// t@Cgame_indexǖڂturn^[ڂ܂ōČĕ\
+void replayGame(const std::string &path, const int game_index, const int turn)
+{
+    using std::cout;
+    using std::endl;
+    std::ifstream ifs(path);
+    GameRecord record;
+    for (int i = 0; i <= game_index; i++)
+    {
+        if (!record.read(ifs))
+            throw std::string("no game record ") + std::to_string(game_index) + " in " + path;
+    }
+    cout << "turn " << turn << " / " << record.actions.size() << endl;
+    if (turn > 0 && turn <= (int)record.actions.size())
+    {
+        const auto &action = record.actions[turn - 1];
+        const auto &microsecond = record.microseconds[turn - 1];
+        cout << "actions " << dstr[action[0]] << " " << dstr[action[1]]
+             << " (" << microsecond[0] << "us, " << microsecond[1] << "us)" << endl;
+    }
+    cout << record.replay(turn).toString() << endl;
+}
+
+#ifndef _WIN32
+// configurations[task.configuration]AȊgŁAtask.seedh*w̔Ֆʂ1vCAũXRA v1sԂ
+std::string playFarmGame(const std::vector<std::vector<StringAIPair>> &configurations, const farm::Task &task, const int h, const int w)
+{
+    mt.seed(task.seed);
+    const auto record = recordGame(configurations[task.configuration], h, w, (int)task.seed);
+    std::stringstream ss;
+    ss << record.replay((int)record.actions.size()).getFirstPlayerScoreForWinRate() << ' ';
+    record.write(ss);
+    std::string result = ss.str();
+    result.pop_back(); // writets
+    return result;
+}
+
+// R[fBl[^[Ƃđ҂󂯁AʂɋN[J[game_numberǂ𕪒SČʂresult_pathɒǋL
+void runFarmCoordinator(const std::string &socket_path, const std::string &result_path, const int game_number, const int configuration_number)
+{
+    farm::Coordinator coordinator(socket_path, result_path, game_number, configuration_number);
+    while (!coordinator.isFinished())
+    {
+        coordinator.step(farm::POLL_INTERVAL);
+    }
+    coordinator.shutdown();
+    std::cout << coordinator.summary();
+}
+
+// [J[ƂăR[fBl[^[ɐڑAnꂽԍAȊgh*w̔ՖʂvC
+void runFarmWorker(const std::string &socket_path, const std::vector<std::vector<StringAIPair>> &configurations, const int h, const int w)
+{
+    farm::runWorker(socket_path, [&](const farm::Task &task) { return playFarmGame(configurations, task, h, w); });
+}
+
+// R[fBl[^[worker_number̃[J[vZXNAconfigurations̊eAȊgh*w̔Ֆʂgame_number񕪒SăvC
+// rŏI[J[͋NBʃt@CcĂ΁AIĂȂǂĊJ
+void runFarm(const std::string &socket_path, const std::string &result_path, const int game_number, const std::vector<std::vector<StringAIPair>> &configurations, const int worker_number, const int h, const int w)
+{
+    farm::Coordinator coordinator(socket_path, result_path, game_number, (int)configurations.size());
+    std::vector<pid_t> pids;
+    const auto spawn = [&]()
+    {
+        const pid_t pid = fork();
+        if (pid < 0)
+            throw std::string("cannot fork worker");
+        if (pid == 0)
+        {
+            coordinator.releaseSockets();
+            try
+            {
+                runFarmWorker(socket_path, configurations, h, w);
+            }
+            catch (const std::string &error)
+            {
+                std::cerr << error << std::endl;
+                _exit(1);
+            }
+            _exit(0);
+        }
+        pids.emplace_back(pid);
+    };
+    for (int i = 0; i < worker_number && !coordinator.isFinished(); i++)
+    {
+        spawn();
+    }
+    while (!coordinator.isFinished())
+    {
+        coordinator.step(farm::POLL_INTERVAL);
+        pid_t pid;
+        while ((pid = waitpid(-1, nullptr, WNOHANG)) > 0)
+        {
+            pids.erase(std::remove(pids.begin(), pids.end(), pid), pids.end());
+            if (!coordinator.isFinished())
+            {
+                std::cerr << "worker " << pid << " exited, restarting" << std::endl;
+                spawn();
+            }
+        }
+    }
+    // SďÎŁAڑ҂̃[J[ɂI`A܂ڑĂȂ[J[͎~߂
+    coordinator.shutdown();
+    for (const auto pid : pids)
+    {
+        kill(pid, SIGTERM);
+        waitpid(pid, nullptr, 0);
+    }
+    std::cout << coordinator.summary();
+}
+#endif
+// m䌟(SPRT)ŁA1sƂ̓_̕ςmean0mean1𔻒肷NX
+// _͐KzŋߎAU͊ϑl琄肷
+class SequentialTest
+{
+private:
+    double mean0_;       // A̕
+    double mean1_;       // Η̕
+    double lower_bound_; // ΐޓx䂪Ȃ
+    double upper_bound_; // ΐޓx䂪Η̑
+    int n_;
+    double sum_;
+    double square_sum_;
+
+    // SȂǂŕU0ɂȂƔłȂ߁A̕ς1񂸂ϑ̂ƂĕU𐄒肷
+    double regularizedVariance() const
+    {
+        const double n = this->n_ + 2;
+        const double mean = (this->sum_ + this->mean0_ + this->mean1_) / n;
+        return std::max(0.0, (this->square_sum_ + this->mean0_ * this->mean0_ + this->mean1_ * this->mean1_) / n - mean * mean);
+    }
+
+public:
+    enum Result
+    {
+        CONTINUE,
+        ACCEPT_H0,
+        ACCEPT_H1,
+    };
+
+    // AƑΗ̕ρA1̌藦alphaA2̌藦betaw肵ăCX^X
+    SequentialTest(const double mean0, const double mean1, const double alpha, const double beta)
+        : mean0_(mean0),
+          mean1_(mean1),
+          lower_bound_(log(beta / (1 - alpha))),
+          upper_bound_(log((1 - beta) / alpha)),
+          n_(0),
+          sum_(0),
+          square_sum_(0)
+    {
+    }
+
+    // 1s̓_ǉ
+    void add(const double score)
+    {
+        this->n_++;
+        this->sum_ += score;
+        this->square_sum_ += score * score;
+    }
+
+    // s񐔂Ԃ
+    int size() const
+    {
+        return this->n_;
+    }
+
+    // _̕ςԂ
+    double mean() const
+    {
+        return this->n_ == 0 ? 0 : this->sum_ / this->n_;
+    }
+
+    // _̕ς̐MԂ̔ԂBz͐Kz̕ʓ_ŁA1.96Ȃ95%M
+    double margin(const double z = 1.96) const
+    {
+        if (this->n_ == 0)
+            return 0;
+        return z * sqrt(this->regularizedVariance() / this->n_);
     }
+
+    // ΐޓxԂB2sł0
+    double llr() const
+    {
+        const double variance = this->regularizedVariance();
+        if (this->n_ < 2 || variance <= 0)
+            return 0;
+        return (this->mean1_ - this->mean0_) * (2 * this->sum_ - this->n_ * (this->mean0_ + this->mean1_)) / (2 * variance);
+    }
+
+    // _̌茋ʂԂ
+    Result result() const
+    {
+        const double llr = this->llr();
+        if (llr <= this->lower_bound_)
+            return ACCEPT_H0;
+        if (llr >= this->upper_bound_)
+            return ACCEPT_H1;
+        return CONTINUE;
+    }
+
+    double lowerBound() const
+    {
+        return this->lower_bound_;
+    }
+
+    double upperBound() const
+    {
+        return this->upper_bound_;
+    }
+};
+
+// Eloғ_(1A0.5A0)ɕϊ
+double eloToScore(const double elo)
+{
+    return 1.0 / (1.0 + pow(10.0, -elo / 400.0));
 }
+
+// ғ_EloɕϊB01͗L̒lɊۂ߂
+double scoreToElo(const double score)
+{
+    const double clamped_score = std::min(std::max(score, 1e-6), 1 - 1e-6);
+    return -400.0 * log10(1.0 / clamped_score - 1.0);
+}
+
+// _̕ςƐMԂ̔AElǒ덷Ԃ
+double eloMargin(const double mean, const double margin)
+{
+    return (scoreToElo(mean + margin) - scoreToElo(mean - margin)) / 2;
+}
+
 // Q[game_numbervCais0ԖڂAȈ\B
 void testFirstPlayerWinRate(const std::vector<StringAIPair> &ais)
 {
@@ -613,10 +2800,6 @@ void testFirstPlayerWinRate(const std::vector<StringAIPair> &ais)
                     break;
             }
             double win_rate_point = state.getFirstPlayerScoreForWinRate();
-            if (win_rate_point >= 0)
-            {
-                state.toString();
-            }
             first_player_win_rate += win_rate_point;
 
             cout << "i " << i << " w " << first_player_win_rate / (i + 1) << endl;
@@ -626,8 +2809,66 @@ void testFirstPlayerWinRate(const std::vector<StringAIPair> &ais)
     }
 }
 
+// Ht@Cǂݍ񂾊eH1񂸂ΐ킵AvC[0̏\
+void testFirstPlayerWinRate(const std::vector<StringAIPair> &ais, const std::vector<std::shared_ptr<const MazeBoard>> &boards)
+{
+    using std::cout;
+    using std::endl;
+
+    double first_player_win_rate = 0;
+    for (int i = 0; i < (int)boards.size(); i++)
+    {
+        auto state = State(boards[i]);
+        while (!state.isDone())
+        {
+            state.advance(ais[0].second(state, 0), ais[1].second(state, 1));
+        }
+        first_player_win_rate += state.getFirstPlayerScoreForWinRate();
+
+        cout << "i " << i << " w " << first_player_win_rate / (i + 1) << endl;
+    }
+    first_player_win_rate /= (double)boards.size();
+    cout << "Winning rate of " << ais[0].first << " to " << ais[1].first << ":\t" << first_player_win_rate << endl;
+}
+
+// Eloelo0AAelo1ΗƂSPRTŁALӂɂȂ܂ōőmax_game_numbervCA
+// ais0ԖڂAȈElo\B
+void testFirstPlayerWinRateWithSprt(const std::vector<StringAIPair> &ais, const int max_game_number, const double elo0, const double elo1, const double alpha = 0.05, const double beta = 0.05)
+{
+    using std::cout;
+    using std::endl;
+
+    auto test = SequentialTest(eloToScore(elo0), eloToScore(elo1), alpha, beta);
+    for (int i = 0; i < max_game_number; i++)
+    {
+        auto state = State(5, 5, mt());
+        auto &first_ai = ais[0];
+        auto &second_ai = ais[1];
+        while (true)
+        {
+            state.advance(first_ai.second(state, 0), second_ai.second(state, 1));
+            if (state.isDone())
+                break;
+        }
+        test.add(state.getFirstPlayerScoreForWinRate());
+
+        cout << "i " << i << " w " << test.mean()
+             << " elo " << scoreToElo(test.mean()) << " +- " << eloMargin(test.mean(), test.margin())
+             << " llr " << test.llr() << " [" << test.lowerBound() << ", " << test.upperBound() << "]" << endl;
+        if (test.result() != SequentialTest::CONTINUE)
+            break;
+    }
+    const auto result = test.result();
+    cout << "Winning rate of " << ais[0].first << " to " << ais[1].first << ":\t" << test.mean()
+         << "\telo " << scoreToElo(test.mean()) << " +- " << eloMargin(test.mean(), test.margin())
+         << "\t" << (result == SequentialTest::ACCEPT_H1 ? "H1" : result == SequentialTest::ACCEPT_H0 ? "H0" : "no decision")
+         << " after " << test.size() << " games" << endl;
+}
+
 int main()
 {
+    DuctSearcher duct_searcher; // Ԃ܂ŒT؂p߁AAI̊Oŕێ
+    // duct_searcher.setNodeBudget(NodeBudget{/*m[h*/ 0, /*oCg*/ 64 << 20, /*ŕ؂̂Ă邩*/ true}); // T؂̃64MiB܂łɗ}
     std::vector<StringAIPair> ais = {
         // StringAIPair("randomAction",[](const State& state,const int player_id) {return randomAction(state,player_id); }),
         StringAIPair("primitiveMontecarloAction", [&](const State &state, const int player_id)
@@ -635,8 +2876,27 @@ int main()
         StringAIPair("ductAction", [&](const State &state, const int player_id)
                      { return ductAction(state, player_id, 1000); }),
         // StringAIPair("ductActionWithTimeThreshold",[&](const State& state,const int player_id) {return ductActionWithTimeThreshold(state,player_id,10); }),
+        // StringAIPair("ductActionWithNodeBudget",[&](const State& state,const int player_id) {TreeStatistics statistics; const auto action = ductActionWithTimeThreshold(state,player_id,10,NodeBudget{/*m[h*/0,/*oCg*/1 << 20,/*ŕ؂̂Ă邩*/true},&statistics); std::cerr << "nodes " << statistics.node_number << " bytes " << statistics.byte_size << " pruned " << statistics.pruned_node_number << std::endl; return action; }),
+        // StringAIPair("beamSearchAction",[&](const State& state,const int player_id) {return beamSearchAction(state,player_id,10,20); }),
+        // StringAIPair("beamSearchActionWithTimeThreshold",[&](const State& state,const int player_id) {return beamSearchActionWithTimeThreshold(state,player_id,10,10); }),
+        // StringAIPair("ductNashAction",[&](const State& state,const int player_id) {return ductNashAction(state,player_id,1000); }),
+        // StringAIPair("primitiveMontecarloNashAction",[&](const State& state,const int player_id) {return primitiveMontecarloNashAction(state,player_id,100); }),
+        // StringAIPair("exp3Action",[&](const State& state,const int player_id) {return exp3Action(state,player_id,1000); }),
+        // StringAIPair("regretMatchingAction",[&](const State& state,const int player_id) {return regretMatchingAction(state,player_id,1000); }),
+        // StringAIPair("ductActionWithTimeThresholdParallel",[&](const State& state,const int player_id) {return ductActionWithTimeThresholdParallel(state,player_id,10,std::thread::hardware_concurrency()); }),
+        // StringAIPair("ductSearcherWithTimeThreshold",[&](const State& state,const int player_id) {return duct_searcher.actionWithTimeThreshold(state,player_id,10); }),
     };
+    // runSelfPlay("simultaneous_selfplay.bin", /*ΐ퐔*/ 10000, /*1肠̃vCAEg*/ 1000, /*Xbh*/ std::thread::hardware_concurrency()); // wKf[^
     playGame(ais);
+    // playGame(ais, /*^[Ֆʂ\邩*/ false); // Ֆʂ̕\Ōゾɂđ΋ǂ𑬂
+    // { std::ofstream record_stream("game_records.txt"); for (int i = 0; i < 100; i++) recordGame(ais, /*Ֆʂ̍*/ 5, /*Ֆʂ̕*/ 5, /*Ֆʏ̃V[h*/ i).write(record_stream); } // Ֆʂ\ɊL^
+    // replayGame("game_records.txt", /**/ 0, /*^[*/ 10); // L^̔ՖʂČ
+    // runFarm("/tmp/simultaneous_farm.sock", "farm_results.txt", /*ΐ퐔*/ 1000, {ais, {ais[1], ais[0]}}, /*[J[*/ std::thread::hardware_concurrency(), /*Ֆʂ̍*/ 5, /*Ֆʂ̕*/ 5); // ւ2̑g𕡐vZXőΐ킷
+    // runFarmCoordinator("/tmp/simultaneous_farm.sock", "farm_results.txt", /*ΐ퐔*/ 1000, /*AȊg̐*/ 2); // [J[͕ʂɋN(numactlNUMAm[hƂɋNȂ)
+    // runFarmWorker("/tmp/simultaneous_farm.sock", {ais, {ais[1], ais[0]}}, /*Ֆʂ̍*/ 5, /*Ֆʂ̕*/ 5); // R[fBl[^[ƓAȊgn
     // testFirstPlayerWinRate(ais);
+    // mazefile::generateDirectory("mazes", /*H̐*/ 10, /*Ֆʂ̍*/ 999, /*Ֆʂ̕*/ 999); // x`}[Np̖Ht@C
+    // testFirstPlayerWinRate(ais, mazefile::loadDirectory("mazes")); // Ht@C̔ՖʂŃeXg
+    // testFirstPlayerWinRateWithSprt(ais, /*őΐ*/ 1000, /*AElo*/ 0, /*ΗElo*/ 50);
     return 0;
 }
\ No newline at end of file